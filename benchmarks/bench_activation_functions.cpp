@@ -0,0 +1,45 @@
+#include "activation_functions.hpp"
+#include "fixtures.hpp"
+#include <Eigen/Dense>
+#include <benchmark/benchmark.h>
+
+namespace bench_activation_functions {
+/*
+  Number of channels of the hidden layers in the default model.
+*/
+const int CHANNELS = 250;
+
+#pragma region Forward pass
+template <typename T>
+static void BM_ActivationForward(benchmark::State &state) {
+  int batchSize = state.range(0);
+  T activation;
+  Eigen::MatrixXd input = Eigen::MatrixXd::Random(batchSize, CHANNELS);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(activation.forward(input));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK_TEMPLATE(BM_ActivationForward, activation_functions::NoActivation)
+    ->Apply(bench_fixtures::batchSizes);
+BENCHMARK_TEMPLATE(BM_ActivationForward, activation_functions::ReLU)
+    ->Apply(bench_fixtures::batchSizes);
+#pragma endregion Forward pass
+
+#pragma region Backward pass
+template <typename T>
+static void BM_ActivationBackward(benchmark::State &state) {
+  int batchSize = state.range(0);
+  T activation;
+  activation.forward(Eigen::MatrixXd::Random(batchSize, CHANNELS));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(activation.backward());
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK_TEMPLATE(BM_ActivationBackward, activation_functions::NoActivation)
+    ->Apply(bench_fixtures::batchSizes);
+BENCHMARK_TEMPLATE(BM_ActivationBackward, activation_functions::ReLU)
+    ->Apply(bench_fixtures::batchSizes);
+#pragma endregion Backward pass
+} // namespace bench_activation_functions
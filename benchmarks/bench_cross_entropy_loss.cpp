@@ -0,0 +1,36 @@
+#include "cross_entropy_loss.hpp"
+#include "fixtures.hpp"
+#include <Eigen/Dense>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace bench_cross_entropy_loss {
+#pragma region Forward
+static void BM_CrossEntropyLossForward(benchmark::State &state) {
+  int batchSize = state.range(0);
+  loss::CrossEntropyLoss loss;
+  Eigen::MatrixXd logits =
+      Eigen::MatrixXd::Random(batchSize, bench_fixtures::NUM_CLASSES);
+  std::vector<int> labels = bench_fixtures::getLabels(batchSize);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(loss.forward(logits, labels));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_CrossEntropyLossForward)->Apply(bench_fixtures::batchSizes);
+#pragma endregion Forward
+
+#pragma region Backward
+static void BM_CrossEntropyLossBackward(benchmark::State &state) {
+  int batchSize = state.range(0);
+  loss::CrossEntropyLoss loss;
+  loss.forward(Eigen::MatrixXd::Random(batchSize, bench_fixtures::NUM_CLASSES),
+               bench_fixtures::getLabels(batchSize));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(loss.backward());
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_CrossEntropyLossBackward)->Apply(bench_fixtures::batchSizes);
+#pragma endregion Backward
+} // namespace bench_cross_entropy_loss
@@ -0,0 +1,46 @@
+#include "fixtures.hpp"
+#include "linear.hpp"
+#include <Eigen/Dense>
+#include <benchmark/benchmark.h>
+
+namespace bench_linear {
+#pragma region Forward pass
+static void BM_LinearForward(benchmark::State &state) {
+  int batchSize = state.range(0);
+  linear::Linear layer(state.range(1), state.range(2), "ReLU");
+  Eigen::MatrixXd input = Eigen::MatrixXd::Random(batchSize, layer.inChannels);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(layer.forward(input));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_LinearForward)->Apply(bench_fixtures::batchAndLayerSizes);
+#pragma endregion Forward pass
+
+#pragma region Backward pass
+static void BM_LinearBackward(benchmark::State &state) {
+  int batchSize = state.range(0);
+  linear::Linear layer(state.range(1), state.range(2), "ReLU");
+  layer.forward(Eigen::MatrixXd::Random(batchSize, layer.inChannels));
+  Eigen::MatrixXd grad = Eigen::MatrixXd::Random(batchSize, layer.outChannels);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(layer.backward(grad));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_LinearBackward)->Apply(bench_fixtures::batchAndLayerSizes);
+
+static void BM_LinearUpdate(benchmark::State &state) {
+  int batchSize = state.range(0);
+  linear::Linear layer(state.range(1), state.range(2), "ReLU");
+  layer.forward(Eigen::MatrixXd::Random(batchSize, layer.inChannels));
+  Eigen::MatrixXd grad = Eigen::MatrixXd::Random(batchSize, layer.outChannels);
+  for (auto _ : state) {
+    // A tiny learning rate keeps the parameters stable across iterations.
+    benchmark::DoNotOptimize(layer.update(grad, 1e-12));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_LinearUpdate)->Apply(bench_fixtures::batchAndLayerSizes);
+#pragma endregion Backward pass
+} // namespace bench_linear
@@ -0,0 +1,44 @@
+#include "fixtures.hpp"
+#include "utils/math.hpp"
+#include <Eigen/Dense>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace bench_math {
+#pragma region One hot encode
+static void BM_OneHotEncode(benchmark::State &state) {
+  int batchSize = state.range(0);
+  std::vector<int> labels = bench_fixtures::getLabels(batchSize);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        utils::math::oneHotEncode(labels, bench_fixtures::NUM_CLASSES));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_OneHotEncode)->Apply(bench_fixtures::batchSizes);
+#pragma endregion One hot encode
+
+#pragma region Softmax
+static void BM_Softmax(benchmark::State &state) {
+  int batchSize = state.range(0);
+  Eigen::MatrixXd logits =
+      Eigen::MatrixXd::Random(batchSize, bench_fixtures::NUM_CLASSES);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(utils::math::softmax(logits));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_Softmax)->Apply(bench_fixtures::batchSizes);
+
+static void BM_LogSoftmax(benchmark::State &state) {
+  int batchSize = state.range(0);
+  Eigen::MatrixXd logits =
+      Eigen::MatrixXd::Random(batchSize, bench_fixtures::NUM_CLASSES);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(utils::math::logSoftmax(logits));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_LogSoftmax)->Apply(bench_fixtures::batchSizes);
+#pragma endregion Softmax
+} // namespace bench_math
@@ -0,0 +1,59 @@
+#include "fixtures.hpp"
+#include "metrics.hpp"
+#include "streaming_metrics.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace bench_metrics {
+#pragma region Confusion matrix
+static void BM_AddToConfusionMatrix(benchmark::State &state) {
+  int batchSize = state.range(0);
+  Eigen::MatrixXi confusionMatrix =
+      metrics::getNewConfusionMatrix(bench_fixtures::NUM_CLASSES);
+  std::vector<int> actual = bench_fixtures::getLabels(batchSize),
+                   predictions = actual;
+  std::rotate(predictions.begin(), predictions.begin() + batchSize / 2,
+              predictions.end());
+  for (auto _ : state) {
+    metrics::addToConfusionMatrix(confusionMatrix, predictions, actual);
+    benchmark::DoNotOptimize(confusionMatrix.data());
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_AddToConfusionMatrix)->Apply(bench_fixtures::batchSizes);
+
+static void BM_AddLogitsToConfusionMatrix(benchmark::State &state) {
+  int batchSize = state.range(0);
+  Eigen::MatrixXi confusionMatrix =
+      metrics::getNewConfusionMatrix(bench_fixtures::NUM_CLASSES);
+  Eigen::MatrixXd logits =
+      Eigen::MatrixXd::Random(batchSize, bench_fixtures::NUM_CLASSES);
+  std::vector<int> actual = bench_fixtures::getLabels(batchSize);
+  for (auto _ : state) {
+    metrics::addToConfusionMatrix(confusionMatrix, logits, actual);
+    benchmark::DoNotOptimize(confusionMatrix.data());
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_AddLogitsToConfusionMatrix)
+    ->Apply(bench_fixtures::batchSizes);
+#pragma endregion Confusion matrix
+
+#pragma region Streaming metrics
+static void BM_UpdateStreamingMetrics(benchmark::State &state) {
+  int batchSize = state.range(0);
+  metrics::StreamingMetrics streaming(
+      {"top_3_accuracy", "confidence_histogram", "calibration_error"});
+  Eigen::MatrixXd logits =
+      Eigen::MatrixXd::Random(batchSize, bench_fixtures::NUM_CLASSES);
+  std::vector<int> actual = bench_fixtures::getLabels(batchSize);
+  for (auto _ : state) {
+    streaming.update(logits, actual);
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_UpdateStreamingMetrics)->Apply(bench_fixtures::batchSizes);
+#pragma endregion Streaming metrics
+} // namespace bench_metrics
@@ -0,0 +1,186 @@
+#include "cross_entropy_loss.hpp"
+#include "fixtures.hpp"
+#include "image_loader.hpp"
+#include "linear.hpp"
+#include "model.hpp"
+#include "pruning.hpp"
+#include "quantisation.hpp"
+#include "utils/timer.hpp"
+#include <Eigen/Dense>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bench_model {
+#pragma region Fixtures
+/*
+  Get the untrained model used by the driver.
+*/
+model::Model getModel() {
+  std::vector<linear::Linear> layers{linear::Linear(784, 250, "ReLU"),
+                                     linear::Linear(250, 250, "ReLU"),
+                                     linear::Linear(250, 10)};
+  return model::Model(layers, loss::CrossEntropyLoss());
+}
+
+/*
+  Get the number of images a training epoch processes, including the
+  validation pass.
+*/
+std::size_t getEpochImages(const loader::ImageLoader &loader) {
+  return loader.getTrainFiles().size() + loader.getTestFiles().size();
+}
+
+/*
+  Run the benchmark for each batch size on a dataset of 1024 images.
+*/
+void datasetAndBatchSizes(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"images", "batch"})
+      ->ArgsProduct({{1024}, {1, 32, 128}})
+      ->Unit(benchmark::kMillisecond);
+}
+#pragma endregion Fixtures
+
+#pragma region Train
+static void BM_TrainEpoch(benchmark::State &state) {
+  const bench_fixtures::SyntheticDataset &dataset =
+      bench_fixtures::getSyntheticDataset(state.range(0));
+  int batchSize = state.range(1);
+  loader::ImageLoader loader(dataset.getRoot(),
+                             loader::ImageLoader::standardPreprocessing,
+                             {".png"});
+  model::Model model = getModel();
+  model::Model::TrainKeywordArgs kwargs{.verbose = false};
+  for (auto _ : state) {
+    model.train(loader, 1e-4, batchSize, 1, kwargs);
+  }
+  state.SetItemsProcessed(state.iterations() * getEpochImages(loader));
+}
+BENCHMARK(BM_TrainEpoch)->Apply(datasetAndBatchSizes);
+
+/*
+  Train for an epoch on the dataset decoded once up front, as in a sweep.
+*/
+static void BM_TrainEpochInMemory(benchmark::State &state) {
+  const bench_fixtures::SyntheticDataset &dataset =
+      bench_fixtures::getSyntheticDataset(state.range(0));
+  int batchSize = state.range(1);
+  loader::ImageLoader source(dataset.getRoot(),
+                             loader::ImageLoader::standardPreprocessing,
+                             {".png"});
+  loader::InMemoryImageLoader loader(source);
+  model::Model model = getModel();
+  model::Model::TrainKeywordArgs kwargs{.verbose = false};
+  for (auto _ : state) {
+    model.train(loader, 1e-4, batchSize, 1, kwargs);
+  }
+  state.SetItemsProcessed(state.iterations() * getEpochImages(source));
+}
+BENCHMARK(BM_TrainEpochInMemory)->Apply(datasetAndBatchSizes);
+
+/*
+  Train for an epoch, timing each stage of the training step.
+*/
+static void BM_TrainEpochStages(benchmark::State &state) {
+  const bench_fixtures::SyntheticDataset &dataset =
+      bench_fixtures::getSyntheticDataset(state.range(0));
+  int batchSize = state.range(1);
+  loader::ImageLoader loader(dataset.getRoot(),
+                             loader::ImageLoader::standardPreprocessing,
+                             {".png"});
+  model::Model model = getModel();
+  utils::timer::StageTimer timer;
+  model::Model::TrainKeywordArgs kwargs{
+      .timings = true, .timer = &timer, .verbose = false};
+
+  std::map<std::string, double> seconds;
+  for (auto _ : state) {
+    model.train(loader, 1e-4, batchSize, 1, kwargs);
+    for (const utils::timer::Timing &timing : timer.getTimings()) {
+      seconds[timing.stage] += timing.seconds;
+    }
+  }
+
+  // Report the seconds spent in each stage per epoch.
+  for (const auto &[stage, total] : seconds) {
+    state.counters[stage] =
+        benchmark::Counter(total, benchmark::Counter::kAvgIterations);
+  }
+  state.SetItemsProcessed(state.iterations() * getEpochImages(loader));
+}
+BENCHMARK(BM_TrainEpochStages)->Apply(datasetAndBatchSizes);
+#pragma endregion Train
+
+#pragma region Test
+static void BM_TestEpoch(benchmark::State &state) {
+  const bench_fixtures::SyntheticDataset &dataset =
+      bench_fixtures::getSyntheticDataset(state.range(0));
+  int batchSize = state.range(1);
+  loader::ImageLoader loader(dataset.getRoot(),
+                             loader::ImageLoader::standardPreprocessing,
+                             {".png"});
+  model::Model model = getModel();
+  model.setClasses(loader.getClasses());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model.test(loader("train", batchSize)));
+  }
+  state.SetItemsProcessed(state.iterations() * loader.getTrainFiles().size());
+}
+BENCHMARK(BM_TestEpoch)->Apply(datasetAndBatchSizes);
+
+static void BM_TestEpochWorkers(benchmark::State &state) {
+  const bench_fixtures::SyntheticDataset &dataset =
+      bench_fixtures::getSyntheticDataset(1024);
+  loader::ImageLoader loader(dataset.getRoot(),
+                             loader::ImageLoader::standardPreprocessing,
+                             {".png"});
+  model::Model model = getModel();
+  model.setClasses(loader.getClasses());
+  model::Model::TestKeywordArgs kwargs;
+  kwargs.workers = state.range(0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model.test(loader("train", 32), "", kwargs));
+  }
+  state.SetItemsProcessed(state.iterations() * loader.getTrainFiles().size());
+}
+BENCHMARK(BM_TestEpochWorkers)
+    ->ArgName("workers")
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+#pragma endregion Test
+
+#pragma region Inference
+static void BM_InferPruned(benchmark::State &state) {
+  double sparsity = state.range(1) / 100.0;
+  model::Model model = pruning::prune(getModel(), sparsity, nullptr);
+  Eigen::MatrixXd input = Eigen::MatrixXd::Random(state.range(0), 784);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model.infer(input));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InferPruned)
+    ->ArgNames({"batch", "sparsity"})
+    ->ArgsProduct({{1, 128}, {0, 50, 75}});
+
+static void BM_InferQuantised(benchmark::State &state) {
+  Eigen::MatrixXd input = Eigen::MatrixXd::Random(state.range(0), 784);
+  auto calibrationData = std::make_shared<loader::InMemoryDatasetBatcher>(
+      std::make_shared<const loader::minibatch>(
+          input, std::vector<int>(input.rows())),
+      input.rows(), loader::DatasetBatcher::KeywordArgs{.shuffle = false});
+  quantisation::QuantisedModel model =
+      quantisation::QuantisedModel::quantise(getModel(), calibrationData, 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model.forward(input));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InferQuantised)->ArgName("batch")->Arg(1)->Arg(128);
+#pragma endregion Inference
+} // namespace bench_model
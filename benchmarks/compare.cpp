@@ -0,0 +1,315 @@
+#include "utils/cli.hpp"
+#include "utils/string.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <tabulate/table.hpp>
+#include <unordered_map>
+#include <vector>
+
+using json = nlohmann::json;
+
+#pragma region Args
+struct Args {
+  std::string baseline, contender, metric = "real_time";
+  double tolerance = 0.05, deviations = 3;
+};
+
+/*
+  Display the help text and exit with the status, which is only 0 when the help
+  text was asked for.
+*/
+void displayHelpText(int status = 0) {
+  std::cout << "usage: benchmark_compare [-h] [--tolerance=<fraction>] "
+               "[--deviations=<k>] [--metric=real_time|cpu_time] baseline "
+               "contender"
+            << "\n\n";
+  std::cout << "Compare Google Benchmark JSON results against a baseline, "
+               "exiting with 1 if any benchmark regressed."
+            << "\n\n";
+
+  tabulate::Table table;
+  table.add_row({"positional arguments:", ""});
+  table.add_row({"baseline", "Path to the baseline results."});
+  table.add_row({"contender", "Path to the results to compare."});
+  table.add_row({"", ""});
+  table.add_row({"options:", ""});
+  table.add_row({"-h, --help", "show this help message and exit"});
+  table.add_row({"--tolerance", "Allowed slowdown as a fraction of the "
+                                "baseline, defaults to 0.05."});
+  table.add_row({"--deviations", "Slowdown required as a multiple of the "
+                                 "combined median absolute deviations, "
+                                 "defaults to 3."});
+  table.add_row(
+      {"--metric", "Time to compare, real_time or cpu_time. Defaults to "
+                   "real_time."});
+
+  table.format().border("").corner("").padding_left(4);
+  std::vector<int> headerRows{0, 4};
+  for (int row : headerRows) {
+    table.row(row).format().padding_left(0);
+  }
+
+  std::cout << table << "\n" << std::endl;
+  exit(status);
+}
+
+/*
+  Parse the arguments.
+*/
+Args parseArgs(int argc, char **argv) {
+  Args args;
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; ++i) {
+    std::string token(argv[i]);
+    if (token == "--help" || token == "-h") {
+      displayHelpText();
+    } else if (token.starts_with("--tolerance=")) {
+      args.tolerance = std::stod(token.substr(token.find('=') + 1));
+      if (args.tolerance < 0) {
+        throw std::invalid_argument(
+            "tolerance must be greater than or equal to 0.");
+      }
+    } else if (token.starts_with("--deviations=")) {
+      args.deviations = std::stod(token.substr(token.find('=') + 1));
+      if (args.deviations < 0) {
+        throw std::invalid_argument(
+            "deviations must be greater than or equal to 0.");
+      }
+    } else if (token.starts_with("--metric=")) {
+      args.metric = token.substr(token.find('=') + 1);
+      if (args.metric != "real_time" && args.metric != "cpu_time") {
+        throw std::invalid_argument(
+            "metric must be either real_time or cpu_time.");
+      }
+    } else {
+      positional.push_back(token);
+    }
+  }
+  if (positional.size() != 2) {
+    utils::cli::printError("Expected a baseline and a contender.");
+    displayHelpText(1);
+  }
+  args.baseline = positional[0];
+  args.contender = positional[1];
+  return args;
+}
+#pragma endregion Args
+
+#pragma region Results
+/*
+  The spread of the repetitions of a benchmark.
+*/
+struct Statistics {
+  double median = 0, deviation = 0;
+  int repetitions = 0;
+  // The error message if any run of the benchmark failed
+  std::string error;
+};
+
+/*
+  Get the median of the values.
+*/
+double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  int middle = values.size() / 2;
+  return values.size() % 2 == 1 ? values[middle]
+                                : (values[middle - 1] + values[middle]) / 2;
+}
+
+/*
+  Convert the time to nanoseconds.
+*/
+double toNanoseconds(double time, const std::string &unit) {
+  static const std::unordered_map<std::string, double> scales{
+      {"ns", 1}, {"us", 1e3}, {"ms", 1e6}, {"s", 1e9}};
+  return time * scales.at(unit);
+}
+
+/*
+  Load the median and median absolute deviation of each benchmark from the
+  results file, using the individual repetitions when available and the median
+  aggregate otherwise. Benchmarks with a failed run only keep the error.
+*/
+std::map<std::string, Statistics> loadResults(const std::string &path,
+                                              const std::string &metric) {
+  if (!std::filesystem::exists(path)) {
+    throw std::invalid_argument(path + " does not exist.");
+  }
+  std::ifstream file(path);
+  json values = json::parse(file);
+
+  std::map<std::string, std::vector<double>> repetitions;
+  std::map<std::string, double> medians;
+  std::map<std::string, std::string> errors;
+  for (const json &benchmark : values["benchmarks"]) {
+    std::string name =
+        benchmark.value("run_name", benchmark["name"].get<std::string>());
+    if (benchmark.value("error_occurred", false)) {
+      errors[name] = benchmark.value("error_message", "unknown error");
+      continue;
+    }
+    double time = toNanoseconds(benchmark[metric].get<double>(),
+                                benchmark.value("time_unit", "ns"));
+    if (benchmark.value("run_type", "iteration") == "iteration") {
+      repetitions[name].push_back(time);
+    } else if (benchmark.value("aggregate_name", "") == "median") {
+      medians[name] = time;
+    }
+  }
+
+  std::map<std::string, Statistics> results;
+  for (const auto &[name, times] : repetitions) {
+    Statistics statistics;
+    statistics.median = median(times);
+    std::vector<double> deviations;
+    for (double time : times) {
+      deviations.push_back(std::abs(time - statistics.median));
+    }
+    statistics.deviation = median(deviations);
+    statistics.repetitions = times.size();
+    results[name] = statistics;
+  }
+  for (const auto &[name, time] : medians) {
+    if (!results.contains(name)) {
+      Statistics statistics;
+      statistics.median = time;
+      statistics.repetitions = 1;
+      results[name] = statistics;
+    }
+  }
+  for (const auto &[name, error] : errors) {
+    Statistics statistics;
+    statistics.error = error;
+    results[name] = statistics;
+  }
+  return results;
+}
+#pragma endregion Results
+
+#pragma region Compare
+/*
+  Format the time in the most readable unit.
+*/
+std::string formatTime(double nanoseconds) {
+  static const std::vector<std::pair<std::string, double>> units{
+      {"s", 1e9}, {"ms", 1e6}, {"us", 1e3}};
+  for (const auto &[unit, scale] : units) {
+    if (nanoseconds >= scale) {
+      return utils::string::floatToString(nanoseconds / scale, 3) + " " + unit;
+    }
+  }
+  return utils::string::floatToString(nanoseconds, 3) + " ns";
+}
+
+/*
+  Compare the contender against the baseline, printing the results and
+  returning the number of regressions, including the benchmarks whose
+  contender failed.
+
+  A benchmark regresses when the median of the contender is slower than the
+  median of the baseline by more than both the tolerance and the given multiple
+  of the sum of their median absolute deviations, so noisy benchmarks need a
+  larger slowdown to regress. Improvements are judged the same way.
+*/
+int compare(const std::map<std::string, Statistics> &baseline,
+            const std::map<std::string, Statistics> &contender,
+            double tolerance, double deviations) {
+  tabulate::Table table;
+  table.add_row({"Benchmark", "Baseline", "Contender", "Change", "Status"});
+
+  int regressions = 0;
+  for (const auto &[name, result] : contender) {
+    if (!result.error.empty()) {
+      table.add_row({name, "-", "-", "-", "ERROR"});
+      utils::cli::printError(name + " failed: " + result.error);
+      ++regressions;
+      continue;
+    }
+    if (!baseline.contains(name) || !baseline.at(name).error.empty()) {
+      table.add_row({name, "-", formatTime(result.median), "-", "NEW"});
+      continue;
+    }
+
+    const Statistics &base = baseline.at(name);
+    double difference = result.median - base.median,
+           change = difference / base.median,
+           noise = deviations * (base.deviation + result.deviation),
+           threshold = std::max(tolerance * base.median, noise);
+    std::string status = "OK";
+    if (difference > threshold) {
+      status = "REGRESSION";
+      ++regressions;
+    } else if (difference < -threshold) {
+      status = "IMPROVED";
+    }
+    table.add_row(
+        {name,
+         formatTime(base.median) + " +/- " + formatTime(base.deviation),
+         formatTime(result.median) + " +/- " + formatTime(result.deviation),
+         (change > 0 ? "+" : "") +
+             utils::string::floatToString(change * 100, 2) + "%",
+         status});
+  }
+  for (const auto &[name, result] : baseline) {
+    if (!contender.contains(name) && result.error.empty()) {
+      table.add_row({name, formatTime(result.median), "-", "-", "MISSING"});
+    }
+  }
+
+  // Style table
+  table.format()
+      .border(" ")
+      .corner(" ")
+      .font_align(tabulate::FontAlign::right)
+      .hide_border_top()
+      .hide_border_bottom();
+  table.column(0).format().font_align(tabulate::FontAlign::left);
+  table.row(0)
+      .format()
+      .font_style({tabulate::FontStyle::bold})
+      .font_align(tabulate::FontAlign::center)
+      .show_border_top();
+  table.row(1).format().border_top("-").show_border_top();
+
+  std::cout << table << std::endl;
+  return regressions;
+}
+#pragma endregion Compare
+
+int main(int argc, char **argv) {
+  Args args = parseArgs(argc, argv);
+  std::map<std::string, Statistics> baseline =
+                                        loadResults(args.baseline, args.metric),
+                                    contender = loadResults(args.contender,
+                                                            args.metric);
+
+  for (const auto &[name, result] : contender) {
+    if (result.error.empty() && result.repetitions < 3) {
+      utils::cli::printWarning(
+          "Some benchmarks have fewer than 3 repetitions, their medians may "
+          "be noisy. Run the benchmarks with --benchmark_repetitions.");
+      break;
+    }
+  }
+
+  int regressions =
+      compare(baseline, contender, args.tolerance, args.deviations);
+  if (regressions > 0) {
+    utils::cli::printError(std::to_string(regressions) +
+                           " benchmark(s) failed or regressed by more than " +
+                           utils::string::floatToString(args.tolerance * 100,
+                                                        2) +
+                           "% and their noise.");
+    return 1;
+  }
+  std::cout << "No benchmarks regressed." << std::endl;
+  return 0;
+}
\ No newline at end of file
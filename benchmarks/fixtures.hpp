@@ -0,0 +1,120 @@
+#pragma once
+#include <Eigen/Dense>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <opencv2/core.hpp>
+#include <opencv2/core/eigen.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench_fixtures {
+/*
+  Batch sizes from single image inference up to large training batches.
+*/
+const std::vector<std::int64_t> BATCH_SIZES{1, 8, 32, 128, 256};
+
+/*
+  Input and output channels of the layers in the default model.
+*/
+const std::vector<std::pair<std::int64_t, std::int64_t>> LAYER_SIZES{
+    {784, 250}, {250, 250}, {250, 10}};
+
+/*
+  Number of classes in the default model.
+*/
+const int NUM_CLASSES = 10;
+
+/*
+  Get the labels for a batch, cycling through the classes.
+*/
+inline std::vector<int> getLabels(int batchSize, int numClasses = NUM_CLASSES) {
+  std::vector<int> labels(batchSize);
+  for (int i = 0; i < batchSize; ++i) {
+    labels[i] = i % numClasses;
+  }
+  return labels;
+}
+
+/*
+  Run the benchmark for each batch size.
+*/
+inline void batchSizes(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgName("batch");
+  for (std::int64_t batchSize : BATCH_SIZES) {
+    benchmark->Arg(batchSize);
+  }
+}
+
+/*
+  Run the benchmark for each batch and layer size.
+*/
+inline void batchAndLayerSizes(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"batch", "in", "out"});
+  for (std::int64_t batchSize : BATCH_SIZES) {
+    for (auto [inChannels, outChannels] : LAYER_SIZES) {
+      benchmark->Args({batchSize, inChannels, outChannels});
+    }
+  }
+}
+
+#pragma region Synthetic dataset
+/*
+  MNIST shaped dataset of random 28x28 greyscale images, written in the folder
+  layout expected by the image loader. The images are removed on destruction.
+*/
+class SyntheticDataset {
+  std::filesystem::path root;
+
+public:
+  SyntheticDataset(int size, int numClasses = NUM_CLASSES) {
+    std::mt19937 generator(size);
+    this->root = std::filesystem::temp_directory_path() /
+                 ("nn_benchmark_" + std::to_string(generator()));
+    for (int i = 0; i < numClasses; ++i) {
+      std::filesystem::create_directories(this->root / std::to_string(i));
+    }
+
+    std::uniform_int_distribution<int> pixel(0, 255);
+    for (int i = 0; i < size; ++i) {
+      Eigen::Matrix<unsigned char, Eigen::Dynamic, Eigen::Dynamic> data(28, 28);
+      for (int j = 0; j < data.size(); ++j) {
+        data(j) = pixel(generator);
+      }
+      cv::Mat image;
+      cv::eigen2cv(data, image);
+      cv::imwrite(this->root / std::to_string(i % numClasses) /
+                      (std::to_string(i) + ".png"),
+                  image);
+    }
+  }
+  ~SyntheticDataset() { std::filesystem::remove_all(this->root); }
+
+  SyntheticDataset(const SyntheticDataset &) = delete;
+  SyntheticDataset &operator=(const SyntheticDataset &) = delete;
+
+  /*
+    Get the root of the dataset.
+  */
+  std::filesystem::path getRoot() const { return this->root; }
+};
+
+/*
+  Get the synthetic dataset with the given number of images, creating it on
+  first use so that it is shared between benchmark runs.
+*/
+inline const SyntheticDataset &getSyntheticDataset(int size) {
+  static std::map<int, std::unique_ptr<SyntheticDataset>> datasets;
+  std::unique_ptr<SyntheticDataset> &dataset = datasets[size];
+  if (dataset == nullptr) {
+    dataset = std::make_unique<SyntheticDataset>(size);
+  }
+  return *dataset;
+}
+#pragma endregion Synthetic dataset
+} // namespace bench_fixtures
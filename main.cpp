@@ -1,11 +1,23 @@
+#include "src/checkpoint.hpp"
 #include "src/cross_entropy_loss.hpp"
+#include "src/exceptions/model.hpp"
 #include "src/image_loader.hpp"
 #include "src/linear.hpp"
+#include "src/lr_scheduler.hpp"
 #include "src/model.hpp"
+#include "src/pruning.hpp"
+#include "src/quantisation.hpp"
+#include "src/streaming_metrics.hpp"
+#include "src/sweep.hpp"
+#include "src/utils/allocations.hpp"
 #include "src/utils/cli.hpp"
 #include "src/utils/image.hpp"
+#include "src/utils/indicator.hpp"
 #include "src/utils/string.hpp"
+#include "src/utils/trace.hpp"
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <matplot/backend/backend_interface.h>
 #include <matplot/backend/gnuplot.h>
@@ -13,10 +25,13 @@
 #include <matplot/matplot.h>
 #include <matplot/util/handle_types.h>
 #include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
 #include <readline/history.h>
 #include <readline/readline.h>
 #include <stdexcept>
 #include <tabulate/table.hpp>
+#include <unordered_map>
 #include <yaml-cpp/yaml.h>
 
 #pragma region Helper
@@ -34,13 +49,14 @@ bool hasValue(const YAML::Node &node) {
 struct Args {
   std::string configFile = "config.yaml";
   bool skipToPredictionMode = false;
+  bool headless = false;
 };
 
 /*
   Display the help text and exit.
 */
 void displayHelpText() {
-  std::cout << "usage: NeuralNetwork [-h] [-p] [config_file]"
+  std::cout << "usage: NeuralNetwork [-h] [-p] [--headless] [config_file]"
             << "\n\n";
   std::cout << "Neural network for classifying images of digits."
             << "\n\n";
@@ -52,6 +68,7 @@ void displayHelpText() {
   table.add_row({"options:", ""});
   table.add_row({"-h, --help", "show this help message and exit"});
   table.add_row({"-p, --prediction-mode", "Skip to the prediction mode."});
+  table.add_row({"--headless", "Run without any prompts or graph windows."});
 
   table.format().border("").corner("").padding_left(4);
   std::vector<int> headerRows{0, 3};
@@ -75,6 +92,8 @@ Args parseArgs(int argc, char **argv) {
       displayHelpText();
     } else if (token == "-p" || token == "--prediction-mode") {
       args.skipToPredictionMode = true;
+    } else if (token == "--headless") {
+      args.headless = true;
     } else {
       if (configFileProvided) {
         displayHelpText();
@@ -89,6 +108,15 @@ Args parseArgs(int argc, char **argv) {
   }
   return args;
 }
+
+/*
+  Whether to run without prompts or graph windows, set by either the headless
+  flag or the config file.
+*/
+bool isHeadless(const Args &args, const YAML::Node &config) {
+  return args.headless || (utils::yaml::hasValue(config["headless"]) &&
+                           config["headless"].as<bool>());
+}
 #pragma endregion Args
 
 #pragma region Config
@@ -137,24 +165,165 @@ int getBatchSize(const YAML::Node &config) {
   }
   return batchSize;
 }
+
+/*
+  Get the number of workers to test with from the config file.
+*/
+int getTestWorkers(const YAML::Node &config) {
+  if (!utils::yaml::hasValue(config["test_workers"])) {
+    return 1;
+  }
+  int workers = config["test_workers"].as<int>();
+  if (workers <= 0) {
+    throw std::invalid_argument("test_workers must be greater than 0.");
+  }
+  return workers;
+}
 #pragma endregion Config
 
+#pragma region Image loader
+/*
+  The image loaders of the training and test data, each a nullptr if its path
+  is not provided.
+*/
+struct Loaders {
+  std::shared_ptr<loader::ImageLoader> train, test;
+};
+
+/*
+  Create an image loader, or a nullptr if the dataset's path is not provided.
+*/
+std::shared_ptr<loader::ImageLoader>
+getImageLoader(const YAML::Node &config, const std::string &dataset) {
+  if (!utils::yaml::hasValue(config[dataset + "_path"])) {
+    return nullptr;
+  }
+
+  float trainValidationSplit =
+      dataset == "test" ? 0 : getTrainValidationSplit(config);
+  std::vector<std::string> fileFormats = getFileFormats(config);
+  return std::make_shared<loader::ImageLoader>(
+      config[dataset + "_path"].as<std::string>(),
+      loader::ImageLoader::standardPreprocessing, fileFormats,
+      trainValidationSplit);
+}
+
+/*
+  Create the image loaders once, so each dataset's files are only listed once.
+*/
+Loaders getImageLoaders(const YAML::Node &config) {
+  return {getImageLoader(config, "train"), getImageLoader(config, "test")};
+}
+
+/*
+  Warn that the step is skipped as the dataset's path is not provided.
+*/
+void printMissingDatasetWarning(const std::string &dataset,
+                                const std::string &step) {
+  utils::cli::printWarning("No value for " + dataset +
+                           "_path was provided. Skipping " + step + ".");
+}
+
+/*
+  Get the batcher to report a compressed model on, using the test data and
+  falling back to the validation data. The training loader must be set.
+*/
+std::shared_ptr<loader::DatasetBatcher> getReportBatcher(const Loaders &loaders,
+                                                         int batchSize) {
+  if (loaders.test != nullptr) {
+    return (*loaders.test)("test", batchSize);
+  }
+  return (*loaders.train)("test", batchSize);
+}
+#pragma endregion Image loader
+
 #pragma region Load model
 /*
-  Loads the model using the file provided in the config, or use the default
-  model if no file is provided.
+  Parse the list of layers, each with a size and an optional activation
+  function.
 */
-model::Model getModel(const YAML::Node &config) {
+std::vector<model::LayerConfig> parseLayerConfigs(const YAML::Node &node) {
+  std::vector<model::LayerConfig> layers;
+  for (const YAML::Node &layer : node) {
+    if (!utils::yaml::hasValue(layer["size"])) {
+      throw std::invalid_argument("Each of the layers must have a size.");
+    }
+    model::LayerConfig layerConfig{layer["size"].as<int>()};
+    if (utils::yaml::hasValue(layer["activation"])) {
+      layerConfig.activation = layer["activation"].as<std::string>();
+    }
+    layers.push_back(layerConfig);
+  }
+  return layers;
+}
+
+/*
+  Get the layer configs from the config file, or the default layers with an
+  output layer per class if none are provided.
+*/
+std::vector<model::LayerConfig> getLayerConfigs(const YAML::Node &config,
+                                                int classes) {
+  if (!utils::yaml::hasValue(config["layers"])) {
+    std::vector<model::LayerConfig> layers = model::DEFAULT_HIDDEN_LAYERS;
+    layers.push_back({classes});
+    return layers;
+  }
+  return parseLayerConfigs(config["layers"]);
+}
+
+/*
+  Get the number of input features and classes of the data, inferred from the
+  first image of the training data, falling back to the test data.
+*/
+std::optional<std::pair<int, int>> getDataShape(const Loaders &loaders) {
+  for (const loader::ImageLoader *loader :
+       {loaders.train.get(), loaders.test.get()}) {
+    if (loader == nullptr) {
+      continue;
+    }
+    for (const char *split : {"train", "test"}) {
+      std::shared_ptr<loader::DatasetBatcher> batcher =
+          (*loader)(split, 1, {.shuffle = false});
+      if (batcher->size() > 0) {
+        return std::make_pair((int)(*batcher)[0].first.cols(),
+                              (int)loader->getClasses().size());
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+/*
+  Loads the model using the file provided in the config, or create an untrained
+  model from the layers in the config if no file is provided.
+
+  The model's input size is validated against the data, if any.
+*/
+model::Model getModel(const YAML::Node &config, const Loaders &loaders) {
   if (utils::yaml::hasValue(config["model_path"])) {
-    return model::Model::load(config["model_path"].as<std::string>());
+    model::Model model =
+        model::Model::load(config["model_path"].as<std::string>());
+    std::optional<std::pair<int, int>> shape = getDataShape(loaders);
+    int inputs = model.getLayers().front().inChannels;
+    if (shape.has_value() && shape->first != inputs) {
+      throw exceptions::model::MismatchedInputSizeException(inputs,
+                                                            shape->first);
+    }
+    return model;
   }
 
-  // Load the default model
+  // Create an untrained model, defaulting to 28x28 images of 10 digits
   utils::cli::printWarning(
       "No model file was provided. Loading untrained model.");
-  std::vector<linear::Linear> layers{linear::Linear(784, 250, "ReLU"),
-                                     linear::Linear(250, 250, "ReLU"),
-                                     linear::Linear(250, 10)};
+  std::optional<std::pair<int, int>> shape = getDataShape(loaders);
+  auto [inputs, classes] = shape.value_or(std::make_pair(784, 10));
+  std::vector<model::LayerConfig> layerConfigs =
+      getLayerConfigs(config, classes);
+  if (!shape.has_value()) {
+    classes = layerConfigs.back().size;
+  }
+  std::vector<linear::Linear> layers =
+      model::buildLayers(inputs, layerConfigs, classes);
   loss::CrossEntropyLoss loss;
   model::Model::KeywordArgs kwargs;
   kwargs.setTrainMetricsFromMetricTypes(
@@ -170,44 +339,169 @@ model::Model getModel(const YAML::Node &config) {
 }
 #pragma endregion Load model
 
-#pragma region Image loader
+#pragma region Checkpoint
 /*
-  Create an image loader.
+  Loads the model and training state from the checkpoint if resuming is enabled
+  and the checkpoint exists.
 */
-std::shared_ptr<loader::ImageLoader>
-getImageLoader(const YAML::Node &config, const std::string &dataset) {
-  if (!utils::yaml::hasValue(config[dataset + "_path"])) {
-    utils::cli::printWarning("No value for " + dataset +
-                             "_path was provided. Skipping " + dataset +
-                             "ing.");
-    return nullptr;
+std::optional<std::pair<model::Model, checkpoint::State>>
+getCheckpoint(const YAML::Node &config) {
+  if (!utils::yaml::hasValue(config["checkpoint_path"]) ||
+      !utils::yaml::hasValue(config["resume"]) || !config["resume"].as<bool>()) {
+    return std::nullopt;
   }
 
-  float trainValidationSplit =
-      dataset == "test" ? 0 : getTrainValidationSplit(config);
-  std::vector<std::string> fileFormats = getFileFormats(config);
-  return std::make_shared<loader::ImageLoader>(
-      config[dataset + "_path"].as<std::string>(),
-      loader::ImageLoader::standardPreprocessing, fileFormats,
-      trainValidationSplit);
+  std::string path = config["checkpoint_path"].as<std::string>();
+  if (!std::filesystem::exists(path)) {
+    utils::cli::printWarning("No checkpoint was found at " + path +
+                             ". Starting a new run.");
+    return std::nullopt;
+  }
+  std::cout << "Resuming from the checkpoint at " << path << "." << std::endl;
+  return checkpoint::load(path);
 }
-#pragma endregion Image loader
+
+/*
+  Get the checkpoint options from the config file.
+*/
+void setCheckpointOptions(model::Model::TrainKeywordArgs &kwargs,
+                          const YAML::Node &config) {
+  if (!utils::yaml::hasValue(config["checkpoint_path"])) {
+    return;
+  }
+  kwargs.checkpointPath = config["checkpoint_path"].as<std::string>();
+
+  if (utils::yaml::hasValue(config["checkpoint_epochs"])) {
+    kwargs.checkpointEpochs = config["checkpoint_epochs"].as<int>();
+    if (kwargs.checkpointEpochs < 0) {
+      throw std::invalid_argument(
+          "checkpoint_epochs must be greater than or equal to 0.");
+    }
+  }
+  if (utils::yaml::hasValue(config["checkpoint_minutes"])) {
+    kwargs.checkpointMinutes = config["checkpoint_minutes"].as<double>();
+    if (kwargs.checkpointMinutes < 0) {
+      throw std::invalid_argument(
+          "checkpoint_minutes must be greater than or equal to 0.");
+    }
+  }
+}
+#pragma endregion Checkpoint
 
 #pragma region Train
 /*
-  Train the model base on the config values.
+  Get the learning rate schedule options from the config file.
+*/
+void setScheduleOptions(model::Model::TrainKeywordArgs &kwargs,
+                        const YAML::Node &config, double learningRate) {
+  lr_scheduler::Scheduler::KeywordArgs &schedule = kwargs.learningRateSchedule;
+  if (utils::yaml::hasValue(config["learning_rate_schedule"])) {
+    schedule.schedule = lr_scheduler::scheduleFromString(
+        config["learning_rate_schedule"].as<std::string>());
+  }
+  if (utils::yaml::hasValue(config["warmup_epochs"])) {
+    schedule.warmupEpochs = config["warmup_epochs"].as<double>();
+    if (schedule.warmupEpochs < 0) {
+      throw std::invalid_argument(
+          "warmup_epochs must be greater than or equal to 0.");
+    }
+  }
+  if (utils::yaml::hasValue(config["learning_rate_step_epochs"])) {
+    schedule.stepEpochs = config["learning_rate_step_epochs"].as<int>();
+    if (schedule.stepEpochs < 1) {
+      throw std::invalid_argument(
+          "learning_rate_step_epochs must be greater than 0.");
+    }
+  }
+  if (utils::yaml::hasValue(config["learning_rate_gamma"])) {
+    schedule.gamma = config["learning_rate_gamma"].as<double>();
+    if (schedule.gamma <= 0) {
+      throw std::invalid_argument(
+          "learning_rate_gamma must be greater than 0.");
+    }
+  }
+  if (utils::yaml::hasValue(config["min_learning_rate"])) {
+    schedule.minLearningRate = config["min_learning_rate"].as<double>();
+    if (schedule.minLearningRate < 0 ||
+        schedule.minLearningRate > learningRate) {
+      throw std::invalid_argument(
+          "min_learning_rate must be between 0 and learning_rate.");
+    }
+  }
+}
+
+/*
+  Get the validation and early stopping options from the config file.
 */
-bool trainModel(model::Model &model, const YAML::Node &config) {
+void setValidationOptions(model::Model::TrainKeywordArgs &kwargs,
+                          const YAML::Node &config) {
+  if (utils::yaml::hasValue(config["validation_samples"])) {
+    kwargs.validationSamples = config["validation_samples"].as<int>();
+    if (kwargs.validationSamples < 0) {
+      throw std::invalid_argument(
+          "validation_samples must be greater than or equal to 0.");
+    }
+  }
+  if (utils::yaml::hasValue(config["full_validation_epochs"])) {
+    kwargs.fullValidationEpochs = config["full_validation_epochs"].as<int>();
+    if (kwargs.fullValidationEpochs < 0) {
+      throw std::invalid_argument(
+          "full_validation_epochs must be greater than or equal to 0.");
+    }
+  }
+
+  if (utils::yaml::hasValue(config["early_stopping_patience"])) {
+    kwargs.earlyStoppingPatience = config["early_stopping_patience"].as<int>();
+    if (kwargs.earlyStoppingPatience < 0) {
+      throw std::invalid_argument(
+          "early_stopping_patience must be greater than or equal to 0.");
+    }
+  }
+  if (kwargs.earlyStoppingPatience > 0 && kwargs.validationSamples > 0 &&
+      kwargs.fullValidationEpochs == 0) {
+    throw std::invalid_argument("early_stopping_patience requires "
+                                "full_validation_epochs to be positive when "
+                                "validation_samples is set.");
+  }
+  if (utils::yaml::hasValue(config["early_stopping_metric"])) {
+    kwargs.earlyStoppingMetric =
+        config["early_stopping_metric"].as<std::string>();
+  }
+  if (utils::yaml::hasValue(config["early_stopping_min_delta"])) {
+    kwargs.earlyStoppingMinDelta =
+        config["early_stopping_min_delta"].as<double>();
+    if (kwargs.earlyStoppingMinDelta < 0) {
+      throw std::invalid_argument(
+          "early_stopping_min_delta must be greater than or equal to 0.");
+    }
+  }
+  if (utils::yaml::hasValue(config["restore_best_weights"])) {
+    kwargs.restoreBestWeights = config["restore_best_weights"].as<bool>();
+  }
+}
+
+/*
+  Train the model base on the config values, continuing the checkpointed run if
+  a checkpoint state is provided.
+*/
+bool trainModel(model::Model &model, const YAML::Node &config,
+                const Loaders &loaders,
+                const std::optional<checkpoint::State> &checkpointState) {
+  model::Model::TrainKeywordArgs kwargs;
+  setCheckpointOptions(kwargs, config);
+
   int epochs;
-  if (!utils::yaml::hasValue(config["epochs"]) ||
-      (epochs = config["epochs"].as<int>()) == 0) {
+  double learningRate;
+  if (checkpointState.has_value()) {
+    epochs = checkpointState->epochs;
+    learningRate = checkpointState->learningRate;
+    kwargs.start = *checkpointState;
+  } else if (!utils::yaml::hasValue(config["epochs"]) ||
+             (epochs = config["epochs"].as<int>()) == 0) {
     utils::cli::printWarning(
         "No value for epochs was provided or was 0. Skipping training.");
     return false;
-  }
-
-  double learningRate;
-  if (!utils::yaml::hasValue(config["learning_rate"])) {
+  } else if (!utils::yaml::hasValue(config["learning_rate"])) {
     utils::cli::printWarning(
         "Value of learning_rate not found, defaulting to 1e-4.");
     learningRate = 1e-4;
@@ -218,13 +512,46 @@ bool trainModel(model::Model &model, const YAML::Node &config) {
     throw std::invalid_argument("learning_rate must be greater than 0.");
   }
 
+  setScheduleOptions(kwargs, config, learningRate);
+
+  if (utils::yaml::hasValue(config["timings"])) {
+    kwargs.timings = config["timings"].as<bool>();
+  }
+  if (utils::yaml::hasValue(config["memory_usage"])) {
+    kwargs.memoryUsage = config["memory_usage"].as<bool>();
+  }
+  if (utils::yaml::hasValue(config["allocation_counts"]) &&
+      config["allocation_counts"].as<bool>()) {
+    if (utils::allocations::isEnabled()) {
+      kwargs.allocationCounts = true;
+    } else {
+      utils::cli::printWarning(
+          "Allocations are only counted when built with COUNT_ALLOCATIONS. "
+          "Skipping allocation counts.");
+    }
+  }
+
+  if (utils::yaml::hasValue(config["metrics_log_path"])) {
+    kwargs.metricsLogPath = config["metrics_log_path"].as<std::string>();
+  }
+  if (utils::yaml::hasValue(config["metrics_log_batches"])) {
+    kwargs.metricsLogBatches = config["metrics_log_batches"].as<int>();
+    if (kwargs.metricsLogBatches < 0) {
+      throw std::invalid_argument(
+          "metrics_log_batches must be greater than or equal to 0.");
+    }
+  }
+
+  setValidationOptions(kwargs, config);
+
   int batchSize = getBatchSize(config);
+  kwargs.testWorkers = getTestWorkers(config);
 
-  std::shared_ptr<loader::ImageLoader> loader = getImageLoader(config, "train");
-  if (loader == nullptr) {
+  if (loaders.train == nullptr) {
+    printMissingDatasetWarning("train", "training");
     return false;
   }
-  model.train(*loader, learningRate, batchSize, epochs);
+  model.train(*loaders.train, learningRate, batchSize, epochs, kwargs);
   return true;
 }
 #pragma endregion Train
@@ -275,16 +602,31 @@ void promptSave(const model::Model &model) {
   std::cout << "Model successfully saved at "
             << std::filesystem::canonical(savePath) << "." << std::endl;
 }
+
+/*
+  Save the model to the save path from the config file without prompting.
+*/
+void saveModel(const model::Model &model, const YAML::Node &config) {
+  std::filesystem::path savePath(config["save_path"].as<std::string>());
+  if (savePath.has_parent_path()) {
+    std::filesystem::create_directories(savePath.parent_path());
+  }
+  model.save(savePath);
+  std::cout << "Model successfully saved at "
+            << std::filesystem::canonical(savePath) << "." << std::endl;
+}
 #pragma endregion Save prompt
 
 #pragma region Test
 /*
-  Tests the model if a test set is provided.
+  Tests the model if a test set is provided, returning the test metrics.
 */
-void testModel(model::Model &model, const YAML::Node &config) {
-  std::shared_ptr<loader::ImageLoader> loader = getImageLoader(config, "test");
-  if (loader == nullptr) {
-    return;
+std::unordered_map<std::string, model::metricHistoryValue>
+testModel(model::Model &model, const YAML::Node &config,
+          const Loaders &loaders) {
+  if (loaders.test == nullptr) {
+    printMissingDatasetWarning("test", "testing");
+    return {};
   }
 
   std::vector<std::string> metrics;
@@ -293,33 +635,354 @@ void testModel(model::Model &model, const YAML::Node &config) {
           .empty()) {
     utils::cli::printWarning(
         "No metrics were provided in test_metrics. Skipping testing.");
-    return;
+    return {};
   }
   std::unordered_map<std::string, model::metricHistoryValue> metricHistory =
       model::Model::metricTypesToHistory(metrics);
 
   int batchSize = getBatchSize(config);
 
+  metrics::StreamingMetrics streaming(metrics);
+  model::Model::TestKeywordArgs kwargs;
+  kwargs.workers = getTestWorkers(config);
+  kwargs.streaming = &streaming;
   auto [loss, confusionMatrix] =
-      model.test((*loader)("test", batchSize), "Testing");
-  model::Model::storeMetrics(metricHistory, confusionMatrix, loss);
-  model::Model::printMetrics(metricHistory, loader->getClasses());
+      model.test((*loaders.test)("test", batchSize), "Testing", kwargs);
+  model::Model::storeMetrics(metricHistory, confusionMatrix, loss, &streaming);
+  model::Model::printMetrics(metricHistory, loaders.test->getClasses());
+  return metricHistory;
 }
 #pragma endregion Test
 
+#pragma region Metrics
+/*
+  Save the train and validation history and the test metrics as JSON if a
+  metrics path is provided.
+*/
+void saveMetrics(
+    const model::Model &model,
+    const std::unordered_map<std::string, model::metricHistoryValue>
+        &testMetrics,
+    const YAML::Node &config) {
+  if (!utils::yaml::hasValue(config["metrics_path"])) {
+    return;
+  }
+
+  json values = {
+      {"total_epochs", model.getTotalEpochs()},
+      {"classes", model.getClasses()},
+      {"train", model::Model::metricsHistoryToJson(model.getTrainMetrics())},
+      {"validation",
+       model::Model::metricsHistoryToJson(model.getValidationMetrics())},
+      {"test", model::Model::metricsHistoryToJson(testMetrics)}};
+
+  std::filesystem::path path(config["metrics_path"].as<std::string>());
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path());
+  }
+  std::ofstream file(path);
+  file << values.dump(2);
+  file.close();
+  std::cout << "Metrics saved to " << path.string() << "." << std::endl;
+}
+#pragma endregion Metrics
+
+#pragma region Quantisation
+/*
+  Get the number of calibration batches from the config file.
+*/
+int getCalibrationBatches(const YAML::Node &config) {
+  if (!utils::yaml::hasValue(config["calibration_batches"])) {
+    return 10;
+  }
+  int calibrationBatches = config["calibration_batches"].as<int>();
+  if (calibrationBatches <= 0) {
+    throw std::invalid_argument("calibration_batches must be greater than 0.");
+  }
+  return calibrationBatches;
+}
+
+/*
+  Quantise the model if a quantised model path is provided, reporting the
+  accuracy against the original model and saving the quantised model.
+*/
+void quantiseModel(model::Model &model, const YAML::Node &config,
+                   const Loaders &loaders) {
+  if (!utils::yaml::hasValue(config["quantised_model_path"])) {
+    return;
+  }
+  if (model.getClasses().empty()) {
+    utils::cli::printWarning(
+        "Quantisation is not available for untrained models. Skipping "
+        "quantisation.");
+    return;
+  }
+  if (loaders.train == nullptr) {
+    utils::cli::printWarning("No value for train_path was provided to "
+                             "calibrate with. Skipping quantisation.");
+    return;
+  }
+
+  std::filesystem::path savePath(
+      config["quantised_model_path"].as<std::string>());
+  int batchSize = getBatchSize(config);
+  quantisation::QuantisedModel quantised =
+      quantisation::QuantisedModel::quantise(
+          model, (*loaders.train)("train", batchSize),
+          getCalibrationBatches(config));
+
+  std::shared_ptr<loader::DatasetBatcher> batcher =
+      getReportBatcher(loaders, batchSize);
+  if (batcher->size() > 0) {
+    quantisation::printReport(
+        quantisation::compare(model, quantised, batcher));
+  }
+
+  if (savePath.has_parent_path()) {
+    std::filesystem::create_directories(savePath.parent_path());
+  }
+  quantised.save(savePath);
+  std::cout << "Quantised model successfully saved at "
+            << std::filesystem::canonical(savePath) << "." << std::endl;
+}
+#pragma endregion Quantisation
+
+#pragma region Pruning
+/*
+  Get the pruning options from the config file.
+*/
+double getPruningSparsity(const YAML::Node &config) {
+  if (!utils::yaml::hasValue(config["pruning_sparsity"])) {
+    return 0.5;
+  }
+  double sparsity = config["pruning_sparsity"].as<double>();
+  if (sparsity < 0 || sparsity >= 1) {
+    throw std::invalid_argument(
+        "pruning_sparsity must be between 0 and 1, excluding 1.");
+  }
+  return sparsity;
+}
+
+/*
+  Prune the model if a pruned model path is provided, fine-tuning the pruned
+  model, reporting its accuracy against the original model and saving it.
+*/
+void pruneModel(const model::Model &model, const YAML::Node &config,
+                const Loaders &loaders) {
+  if (!utils::yaml::hasValue(config["pruned_model_path"])) {
+    return;
+  }
+  if (model.getClasses().empty()) {
+    utils::cli::printWarning(
+        "Pruning is not available for untrained models. Skipping pruning.");
+    return;
+  }
+  if (loaders.train == nullptr) {
+    utils::cli::printWarning("No value for train_path was provided to "
+                             "calibrate with. Skipping pruning.");
+    return;
+  }
+
+  std::filesystem::path savePath(config["pruned_model_path"].as<std::string>());
+  int batchSize = getBatchSize(config);
+  pruning::KeywordArgs kwargs;
+  if (utils::yaml::hasValue(config["pruning_criterion"])) {
+    kwargs.criterion = pruning::criterionFromString(
+        config["pruning_criterion"].as<std::string>());
+  }
+  kwargs.calibrationBatches = getCalibrationBatches(config);
+  model::Model pruned =
+      pruning::prune(model, getPruningSparsity(config),
+                     (*loaders.train)("train", batchSize), kwargs);
+
+  // Fine-tune the pruned model to recover the accuracy lost by pruning
+  int epochs = utils::yaml::hasValue(config["fine_tune_epochs"])
+                   ? config["fine_tune_epochs"].as<int>()
+                   : 0;
+  if (epochs < 0) {
+    throw std::invalid_argument(
+        "fine_tune_epochs must be greater than or equal to 0.");
+  }
+  if (epochs > 0) {
+    double learningRate = utils::yaml::hasValue(config["learning_rate"])
+                              ? config["learning_rate"].as<double>()
+                              : 1e-4;
+    model::Model::TrainKeywordArgs trainKwargs;
+    setScheduleOptions(trainKwargs, config, learningRate);
+    trainKwargs.testWorkers = getTestWorkers(config);
+    std::cout << "Fine-tuning the pruned model." << std::endl;
+    pruned.train(*loaders.train, learningRate, batchSize, epochs,
+                 trainKwargs);
+  }
+
+  std::shared_ptr<loader::DatasetBatcher> batcher =
+      getReportBatcher(loaders, batchSize);
+  if (batcher->size() > 0) {
+    pruning::printReport(pruning::compare(model, pruned, batcher));
+  }
+
+  if (savePath.has_parent_path()) {
+    std::filesystem::create_directories(savePath.parent_path());
+  }
+  pruned.save(savePath);
+  std::cout << "Pruned model successfully saved at "
+            << std::filesystem::canonical(savePath) << "." << std::endl;
+}
+#pragma endregion Pruning
+
+#pragma region Trace
+/*
+  Start recording the trace if a trace path is provided.
+*/
+void startTrace(const YAML::Node &config) {
+  if (utils::yaml::hasValue(config["trace_path"])) {
+    utils::trace::start();
+  }
+}
+
+/*
+  Stop recording the trace and save it to the trace path.
+*/
+void saveTrace(const YAML::Node &config) {
+  if (!utils::trace::isEnabled()) {
+    return;
+  }
+  utils::trace::stop();
+  std::string path = config["trace_path"].as<std::string>();
+  utils::trace::save(path);
+  std::cout << "Trace saved to " << path << "." << std::endl;
+}
+#pragma endregion Trace
+
 #pragma region Train and test
 /*
   Train and test the model.
+
+  When headless, the history graphs are skipped and the model is only saved if
+  a save path is provided.
 */
-void trainAndTest(model::Model &model, const YAML::Node &config) {
-  if (trainModel(model, config)) {
-    model.displayHistoryGraphs();
-    promptSave(model);
+void trainAndTest(model::Model &model, const YAML::Node &config,
+                  const Loaders &loaders,
+                  const std::optional<checkpoint::State> &checkpointState,
+                  bool headless) {
+  startTrace(config);
+  if (trainModel(model, config, loaders, checkpointState)) {
+    if (!headless) {
+      model.displayHistoryGraphs();
+    }
+    if (utils::yaml::hasValue(config["save_path"])) {
+      saveModel(model, config);
+    } else if (!headless) {
+      promptSave(model);
+    } else {
+      utils::cli::printWarning(
+          "No save_path was provided. The model was not saved.");
+    }
   }
-  testModel(model, config);
+  std::unordered_map<std::string, model::metricHistoryValue> testMetrics =
+      testModel(model, config, loaders);
+  saveTrace(config);
+  saveMetrics(model, testMetrics, config);
+  quantiseModel(model, config, loaders);
+  pruneModel(model, config, loaders);
 }
 #pragma endregion Train and test
 
+#pragma region Sweep
+/*
+  Get the number of workers to sweep with from the config file.
+*/
+int getSweepWorkers(const YAML::Node &config) {
+  if (!utils::yaml::hasValue(config["sweep_workers"])) {
+    return 1;
+  }
+  int workers = config["sweep_workers"].as<int>();
+  if (workers <= 0) {
+    throw std::invalid_argument("sweep_workers must be greater than 0.");
+  }
+  return workers;
+}
+
+/*
+  Get the trials of the sweep from the config file, where each trial falls back
+  to the top level value of any hyperparameter it does not set.
+*/
+std::vector<sweep::Trial> getTrials(const YAML::Node &config) {
+  std::vector<sweep::Trial> trials;
+  for (const YAML::Node &entry : config["sweep"]) {
+    auto getValue = [&](const std::string &key) {
+      return utils::yaml::hasValue(entry[key]) ? entry[key] : config[key];
+    };
+
+    sweep::Trial trial;
+    trial.name = utils::yaml::hasValue(entry["name"])
+                     ? entry["name"].as<std::string>()
+                     : "Trial " + std::to_string(trials.size() + 1);
+    if (utils::yaml::hasValue(getValue("learning_rate"))) {
+      trial.learningRate = getValue("learning_rate").as<double>();
+    }
+    if (trial.learningRate <= 0) {
+      throw std::invalid_argument("learning_rate must be greater than 0.");
+    }
+    trial.batchSize = utils::yaml::hasValue(entry["batch_size"])
+                          ? entry["batch_size"].as<int>()
+                          : getBatchSize(config);
+    if (trial.batchSize <= 0) {
+      throw std::invalid_argument("batch_size must be greater than 0.");
+    }
+    if (!utils::yaml::hasValue(getValue("epochs")) ||
+        (trial.epochs = getValue("epochs").as<int>()) <= 0) {
+      throw std::invalid_argument("epochs must be greater than 0 for " +
+                                  trial.name + ".");
+    }
+    if (utils::yaml::hasValue(getValue("layers"))) {
+      trial.layers = parseLayerConfigs(getValue("layers"));
+    }
+
+    setScheduleOptions(trial.kwargs, config, trial.learningRate);
+    setValidationOptions(trial.kwargs, config);
+    trial.kwargs.testWorkers = getTestWorkers(config);
+    trials.push_back(trial);
+  }
+  return trials;
+}
+
+/*
+  Train a model per trial of the sweep on the training data, decoded once and
+  shared between the models, then print the comparison of the trials.
+*/
+void runSweep(const YAML::Node &config) {
+  std::vector<sweep::Trial> trials = getTrials(config);
+  std::shared_ptr<loader::ImageLoader> source =
+      getImageLoader(config, "train");
+  if (source == nullptr) {
+    printMissingDatasetWarning("train", "the sweep");
+    return;
+  }
+
+  sweep::RunKeywordArgs kwargs;
+  kwargs.workers = getSweepWorkers(config);
+  if (utils::yaml::hasValue(config["train_metrics"])) {
+    kwargs.trainMetrics =
+        config["train_metrics"].as<std::vector<std::string>>();
+  }
+  if (utils::yaml::hasValue(config["validation_metrics"])) {
+    kwargs.validationMetrics =
+        config["validation_metrics"].as<std::vector<std::string>>();
+  }
+
+  std::cout << "Decoding the training data." << std::endl;
+  loader::InMemoryImageLoader loader(*source);
+  std::cout << "Sweeping " << trials.size() << " trials with "
+            << std::min(kwargs.workers, (int)trials.size()) << " workers."
+            << std::endl;
+  startTrace(config);
+  std::vector<sweep::Result> results = sweep::run(loader, trials, kwargs);
+  saveTrace(config);
+  sweep::printResults(results);
+}
+#pragma endregion Sweep
+
 #pragma region Predict
 /*
   Start the mode that allows users to choose files to predict with the model.
@@ -394,11 +1057,43 @@ void cleanUpHistory() {
 int main(int argc, char **argv) {
   Args args = parseArgs(argc, argv);
   YAML::Node config = getConfig(args.configFile);
-  model::Model model = getModel(config);
+  if (utils::yaml::hasValue(config["progress_bars"])) {
+    utils::indicators::setEnabled(config["progress_bars"].as<bool>());
+  }
+  if (utils::yaml::hasValue(config["sweep"]) && config["sweep"].size() > 0) {
+    runSweep(config);
+    return 0;
+  }
+  std::optional<std::pair<model::Model, checkpoint::State>> checkpoint =
+      getCheckpoint(config);
+  // The data is only needed to train or to size an untrained model
+  Loaders loaders;
+  if (!args.skipToPredictionMode ||
+      (!checkpoint.has_value() &&
+       !utils::yaml::hasValue(config["model_path"]))) {
+    loaders = getImageLoaders(config);
+  }
+  model::Model model =
+      checkpoint.has_value() ? checkpoint->first : getModel(config, loaders);
+
+  bool headless = isHeadless(args, config);
+  if (headless && args.skipToPredictionMode) {
+    utils::cli::printWarning(
+        "Prediction mode is not available when headless. Exiting.");
+    return 0;
+  }
 
   using_history();
   if (!args.skipToPredictionMode) {
-    trainAndTest(model, config);
+    trainAndTest(model, config, loaders,
+                 checkpoint.has_value()
+                     ? std::make_optional(checkpoint->second)
+                     : std::nullopt,
+                 headless);
+  }
+  if (headless) {
+    cleanUpHistory();
+    return 0;
   }
   startPrediction(model, config);
   if (matplot::figure()->number() > 1) {
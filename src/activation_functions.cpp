@@ -1,5 +1,6 @@
 #include "activation_functions.hpp"
 #include "exceptions/differentiable.hpp"
+#include "utils/memory.hpp"
 #include <Eigen/Dense>
 #include <algorithm>
 
@@ -17,6 +18,10 @@ Eigen::MatrixXd ActivationFunction::backward() {
   }
   return *this->input;
 }
+
+std::size_t ActivationFunction::getCacheSize() const {
+  return utils::memory::getSize(this->input);
+}
 #pragma endregion ActivationFunction
 
 #pragma region NoActivation
@@ -26,6 +31,10 @@ Eigen::MatrixXd NoActivation::forward(const Eigen::MatrixXd &input) {
   return ActivationFunction::forward(input);
 }
 
+Eigen::MatrixXd NoActivation::infer(const Eigen::MatrixXd &input) const {
+  return input;
+}
+
 Eigen::MatrixXd NoActivation::backward() {
   ActivationFunction::backward();
   return Eigen::MatrixXd::Ones(this->input->rows(), this->input->cols());
@@ -37,6 +46,10 @@ std::string ReLU::getName() const { return "ReLU"; };
 
 Eigen::MatrixXd ReLU::forward(const Eigen::MatrixXd &input) {
   ActivationFunction::forward(input);
+  return this->infer(input);
+}
+
+Eigen::MatrixXd ReLU::infer(const Eigen::MatrixXd &input) const {
   return input.cwiseProduct((input.array() > 0).cast<double>().matrix());
 }
 
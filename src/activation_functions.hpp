@@ -1,5 +1,6 @@
 #pragma once
 #include <Eigen/Dense>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <typeinfo>
@@ -21,11 +22,20 @@ public:
     Performs the forward pass.
   */
   virtual Eigen::MatrixXd forward(const Eigen::MatrixXd &input) = 0;
+  /*
+    Performs the forward pass without saving the input for the backward pass.
+  */
+  virtual Eigen::MatrixXd infer(const Eigen::MatrixXd &input) const = 0;
   /*
     Performs the backward pass.
   */
   virtual Eigen::MatrixXd backward() = 0;
 
+  /*
+    Get the number of bytes held by the input saved for the backward pass.
+  */
+  std::size_t getCacheSize() const;
+
   /*
     Performs the forward pass.
   */
@@ -51,6 +61,10 @@ public:
     Performs the forward pass.
   */
   Eigen::MatrixXd forward(const Eigen::MatrixXd &input) override;
+  /*
+    Performs the forward pass without saving the input for the backward pass.
+  */
+  Eigen::MatrixXd infer(const Eigen::MatrixXd &input) const override;
   /**
     Performs the backward pass.
   */
@@ -69,6 +83,10 @@ public:
     Performs the forward pass.
   */
   Eigen::MatrixXd forward(const Eigen::MatrixXd &input) override;
+  /*
+    Performs the forward pass without saving the input for the backward pass.
+  */
+  Eigen::MatrixXd infer(const Eigen::MatrixXd &input) const override;
   /*
     Performs the backward pass.
   */
@@ -0,0 +1,159 @@
+#include "checkpoint.hpp"
+#include "cross_entropy_loss.hpp"
+#include "exceptions/checkpoint.hpp"
+#include "exceptions/model.hpp"
+#include "linear.hpp"
+#include "model.hpp"
+#include "model_parser.hpp"
+#include "utils/cli.hpp"
+#include "utils/matrix.hpp"
+#include "utils/trace.hpp"
+#include <exception>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <system_error>
+#include <vector>
+
+using namespace checkpoint;
+
+#pragma region State
+#pragma region Load
+State State::fromJson(const json &values) {
+  State state;
+  state.epoch = values["epoch"];
+  state.epochs = values["epochs"];
+  state.batch = values["batch"];
+  state.learningRate = values["learning_rate"];
+  state.seed = values["seed"];
+  state.loss = values["loss"];
+  state.confusionMatrix =
+      utils::matrix::fromJson(values["confusion_matrix"]).cast<int>();
+  return state;
+}
+#pragma endregion Load
+
+#pragma region Save
+json State::toJson() const {
+  return {{"epoch", this->epoch},
+          {"epochs", this->epochs},
+          {"batch", this->batch},
+          {"learning_rate", this->learningRate},
+          {"seed", this->seed},
+          {"loss", this->loss},
+          {"confusion_matrix", utils::matrix::toJson(this->confusionMatrix)}};
+}
+#pragma endregion Save
+#pragma endregion State
+
+#pragma region Checkpointer
+#pragma region Constructor
+Checkpointer::Checkpointer(std::filesystem::path path)
+    : path(std::move(path)) {
+  if (this->path.extension() != ".json") {
+    throw exceptions::model::InvalidExtensionException(
+        this->path.extension());
+  }
+  if (this->path.has_parent_path()) {
+    std::filesystem::create_directories(this->path.parent_path());
+  }
+  this->worker = std::thread(&Checkpointer::run, this);
+}
+
+Checkpointer::~Checkpointer() {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopping = true;
+  }
+  this->condition.notify_one();
+  this->worker.join();
+}
+#pragma endregion Constructor
+
+#pragma region Save
+void Checkpointer::save(const model::Model &model, const State &state) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    int index = this->writing == 0 ? 1 : 0;
+    if (this->snapshots[index] == nullptr) {
+      this->snapshots[index] = std::make_unique<model::Model>(
+          std::vector<linear::Linear>(), loss::CrossEntropyLoss());
+    }
+    model.copyTo(*this->snapshots[index]);
+    this->states[index] = state;
+    this->pending = index;
+  }
+  this->condition.notify_one();
+}
+#pragma endregion Save
+
+#pragma region Worker
+void Checkpointer::run() {
+  utils::trace::setThreadName("Checkpoint writer");
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->condition.wait(
+          lock, [this] { return this->pending != -1 || this->stopping; });
+      if (this->pending == -1) {
+        return;
+      }
+      this->writing = this->pending;
+      this->pending = -1;
+    }
+
+    try {
+      utils::trace::ScopedEvent event("Write checkpoint", "checkpoint");
+      this->write(*this->snapshots[this->writing],
+                  this->states[this->writing]);
+    } catch (const std::exception &e) {
+      utils::cli::printError("Failed to write checkpoint to " +
+                             this->path.string() + ": " + e.what());
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->writing = -1;
+  }
+}
+
+void Checkpointer::write(const model::Model &snapshot,
+                         const State &state) const {
+  json values = snapshot.toJson();
+  values["checkpoint"] = state.toJson();
+
+  std::filesystem::path tempPath = this->path;
+  tempPath += ".tmp";
+  {
+    std::ofstream file(tempPath);
+    file << values.dump();
+    file.flush();
+    if (!file.good()) {
+      // Keep the previous checkpoint rather than replacing it with a partial
+      // one
+      file.close();
+      std::error_code error;
+      std::filesystem::remove(tempPath, error);
+      throw exceptions::checkpoint::WriteException(tempPath.string());
+    }
+  }
+  std::filesystem::rename(tempPath, this->path);
+}
+#pragma endregion Worker
+#pragma endregion Checkpointer
+
+#pragma region Load
+std::pair<model::Model, State> checkpoint::load(const std::string &path) {
+  std::filesystem::path filePath(path);
+  if (filePath.extension() != ".json") {
+    throw exceptions::model::InvalidExtensionException(filePath.extension());
+  }
+
+  std::ifstream file(filePath);
+  auto [values, layers] = model::parser::parse(file);
+  if (!values.contains("checkpoint")) {
+    throw exceptions::checkpoint::MissingStateException(path);
+  }
+  model::Model model = model::Model::fromJson(values, std::move(layers));
+  return std::make_pair(std::move(model),
+                        State::fromJson(values["checkpoint"]));
+}
+#pragma endregion Load
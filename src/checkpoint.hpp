@@ -0,0 +1,115 @@
+#pragma once
+#include <Eigen/Dense>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json_fwd.hpp>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+
+using json = nlohmann::json;
+
+namespace model {
+class Model;
+}
+
+namespace checkpoint {
+#pragma region State
+/*
+  The training progress stored alongside the model in a checkpoint.
+*/
+struct State {
+  int epoch = 1, epochs = 0, batch = 0;
+  double learningRate = 0;
+  unsigned int seed = std::default_random_engine::default_seed;
+
+  // Results of the batches already trained in the current epoch
+  float loss = 0;
+  Eigen::MatrixXi confusionMatrix;
+
+#pragma region Load
+  /*
+    Create the state from the JSON values.
+  */
+  static State fromJson(const json &values);
+#pragma endregion Load
+
+#pragma region Save
+  /*
+    Get all the relevant attributes in a serialisable format.
+
+    Attributes:
+            - epoch -- the epoch of the run to resume from, starting at 1
+            - epochs -- the total number of epochs in the run
+            - batch -- the minibatch of the epoch to resume from, starting at 0
+            - learning_rate -- the learning rate used by the run
+            - seed -- the seed used to shuffle the training data
+            - loss -- the sum of the losses of the trained minibatches in the
+            epoch
+            - confusion_matrix -- the confusion matrix of the trained
+            minibatches in the epoch
+  */
+  json toJson() const;
+#pragma endregion Save
+};
+#pragma endregion State
+
+#pragma region Checkpointer
+/*
+  Writes model checkpoints on a background thread.
+
+  Saving only copies the model's parameters and metric histories into one of
+  two snapshots owned by the checkpointer, reusing their memory, while the
+  serialisation and writing happen on the background thread. Only the latest
+  snapshot is kept, if a newer snapshot is saved before the previous one is
+  written, the previous one is overwritten. The destructor waits for the
+  pending snapshot to be written.
+*/
+class Checkpointer {
+  std::filesystem::path path;
+  // The snapshot being written is never the one being filled
+  std::unique_ptr<model::Model> snapshots[2];
+  State states[2];
+  int pending = -1, writing = -1;
+  bool stopping = false;
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::thread worker;
+
+  /*
+    Write the pending snapshots until stopped.
+  */
+  void run();
+
+  /*
+    Write the snapshot to the checkpoint path, replacing the previous
+    checkpoint only once the new one is complete. The previous checkpoint is
+    kept if the new one cannot be written in full.
+  */
+  void write(const model::Model &snapshot, const State &state) const;
+
+public:
+  Checkpointer(std::filesystem::path path);
+  ~Checkpointer();
+
+  Checkpointer(const Checkpointer &) = delete;
+  Checkpointer &operator=(const Checkpointer &) = delete;
+
+  /*
+    Snapshot the model and queue the snapshot to be written without waiting
+    for the write.
+  */
+  void save(const model::Model &model, const State &state);
+};
+#pragma endregion Checkpointer
+
+#pragma region Load
+/*
+  Load the model and training state from the checkpoint file.
+*/
+std::pair<model::Model, State> load(const std::string &path);
+#pragma endregion Load
+} // namespace checkpoint
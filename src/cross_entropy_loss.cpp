@@ -4,6 +4,7 @@
 #include "exceptions/load.hpp"
 #include "exceptions/loss.hpp"
 #include "utils/math.hpp"
+#include "utils/memory.hpp"
 #include <Eigen/Dense>
 #include <map>
 #include <nlohmann/json.hpp>
@@ -65,6 +66,21 @@ json CrossEntropyLoss::toJson() const {
 #pragma region Forward
 double CrossEntropyLoss::forward(const Eigen::MatrixXd &logits,
                                  const Eigen::MatrixXi &targets) {
+  double loss = this->evaluate(logits, targets);
+  this->targets = std::make_shared<Eigen::MatrixXi>(targets);
+  this->probabilities =
+      std::make_shared<Eigen::MatrixXd>(utils::math::softmax(logits));
+  return loss;
+}
+
+double CrossEntropyLoss::forward(const Eigen::MatrixXd &logits,
+                                 const std::vector<int> &targets) {
+  return this->forward(logits,
+                       utils::math::oneHotEncode(targets, logits.cols()));
+}
+
+double CrossEntropyLoss::evaluate(const Eigen::MatrixXd &logits,
+                                  const Eigen::MatrixXi &targets) const {
   if (logits.rows() < 1) {
     throw exceptions::eigen::EmptyMatrixException("logits");
   }
@@ -75,19 +91,16 @@ double CrossEntropyLoss::forward(const Eigen::MatrixXd &logits,
   if (logits.rows() != targets.rows() || logits.cols() != targets.cols()) {
     throw exceptions::eigen::InvalidShapeException(logits, targets);
   }
-  this->targets = std::make_shared<Eigen::MatrixXi>(targets);
-  this->probabilities =
-      std::make_shared<Eigen::MatrixXd>(utils::math::softmax(logits));
-  return CrossEntropyLoss::reductions[this->reduction](
+  return CrossEntropyLoss::reductions.at(this->reduction)(
       -(targets.cast<double>().cwiseProduct(utils::math::logSoftmax(logits)))
            .rowwise()
            .sum());
 }
 
-double CrossEntropyLoss::forward(const Eigen::MatrixXd &logits,
-                                 const std::vector<int> &targets) {
-  return this->forward(logits,
-                       utils::math::oneHotEncode(targets, logits.cols()));
+double CrossEntropyLoss::evaluate(const Eigen::MatrixXd &logits,
+                                  const std::vector<int> &targets) const {
+  return this->evaluate(logits,
+                        utils::math::oneHotEncode(targets, logits.cols()));
 }
 #pragma endregion Forward
 
@@ -106,6 +119,13 @@ Eigen::MatrixXd CrossEntropyLoss::backward() {
 }
 #pragma endregion Backward
 
+#pragma region Memory
+std::size_t CrossEntropyLoss::getCacheSize() const {
+  return utils::memory::getSize(this->probabilities) +
+         utils::memory::getSize(this->targets);
+}
+#pragma endregion Memory
+
 #pragma region Builtins
 bool CrossEntropyLoss::operator==(const CrossEntropyLoss &other) const {
   return typeid(*this) == typeid(other) && this->reduction == other.reduction;
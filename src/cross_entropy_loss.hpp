@@ -1,5 +1,6 @@
 #pragma once
 #include <Eigen/Dense>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <nlohmann/json_fwd.hpp>
@@ -67,6 +68,20 @@ public:
   */
   double forward(const Eigen::MatrixXd &logits,
                  const std::vector<int> &targets);
+
+  /*
+    Calculate the cross entropy loss given the logits and the one hot encoded
+    labels, without saving them for the backward pass.
+  */
+  double evaluate(const Eigen::MatrixXd &logits,
+                  const Eigen::MatrixXi &targets) const;
+
+  /*
+    Calculate the cross entropy loss given the logits and the target class
+    labels, without saving them for the backward pass.
+  */
+  double evaluate(const Eigen::MatrixXd &logits,
+                  const std::vector<int> &targets) const;
 #pragma endregion Forward
 
 #pragma region Backward
@@ -76,6 +91,14 @@ public:
   Eigen::MatrixXd backward();
 #pragma endregion Backward
 
+#pragma region Memory
+  /*
+    Get the number of bytes held by the probabilities and targets saved for the
+    backward pass.
+  */
+  std::size_t getCacheSize() const;
+#pragma endregion Memory
+
 #pragma region Builtins
   /*
     Calculate the cross entropy loss given the logits and the one hot encoded
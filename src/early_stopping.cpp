@@ -0,0 +1,46 @@
+#include "early_stopping.hpp"
+#include "exceptions/early_stopping.hpp"
+#include "metrics.hpp"
+#include "streaming_metrics.hpp"
+
+using namespace early_stopping;
+
+EarlyStopping::EarlyStopping(const std::string &metric, int patience,
+                             double minDelta)
+    : metric(metric), patience(patience), minDelta(minDelta),
+      lowerIsBetter(metrics::LOWER_IS_BETTER_METRICS.contains(metric)) {
+  if (!metrics::isSingleValueMetric(metric)) {
+    throw exceptions::early_stopping::InvalidMetricException(metric);
+  }
+  if (patience < 1) {
+    throw exceptions::early_stopping::InvalidPatienceException(patience);
+  }
+  if (minDelta < 0) {
+    throw exceptions::early_stopping::InvalidMinDeltaException(minDelta);
+  }
+}
+
+#pragma region Properties
+const std::string &EarlyStopping::getMetric() const { return this->metric; }
+
+int EarlyStopping::getBestEpoch() const { return this->bestEpoch; }
+
+float EarlyStopping::getBest() const { return this->best; }
+#pragma endregion Properties
+
+#pragma region Update
+bool EarlyStopping::update(float value, int epoch) {
+  double improvement =
+      this->lowerIsBetter ? this->best - value : value - this->best;
+  if (this->bestEpoch == 0 || improvement > this->minDelta) {
+    this->best = value;
+    this->bestEpoch = epoch;
+    this->wait = 0;
+    return true;
+  }
+  ++this->wait;
+  return false;
+}
+
+bool EarlyStopping::shouldStop() const { return this->wait >= this->patience; }
+#pragma endregion Update
@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+
+namespace early_stopping {
+/*
+  Tracks a validation metric to stop training once it stops improving.
+
+  An epoch improves on the best epoch if its value is better by more than the
+  min delta, where lower is better for the loss and calibration error and
+  higher is better for the other metrics. Training stops once patience epochs
+  in a row have not improved.
+*/
+class EarlyStopping {
+  std::string metric;
+  int patience;
+  double minDelta;
+  bool lowerIsBetter;
+  float best = 0;
+  int bestEpoch = 0, wait = 0;
+
+public:
+  EarlyStopping(const std::string &metric, int patience, double minDelta);
+
+  /*
+    Get the tracked metric.
+  */
+  const std::string &getMetric() const;
+
+  /*
+    Get the epoch with the best value, or 0 if no epoch has been recorded.
+  */
+  int getBestEpoch() const;
+
+  /*
+    Get the best value recorded.
+  */
+  float getBest() const;
+
+  /*
+    Record the value of the epoch, returning whether it is the new best.
+  */
+  bool update(float value, int epoch);
+
+  /*
+    Whether the metric has not improved for patience epochs.
+  */
+  bool shouldStop() const;
+};
+} // namespace early_stopping
@@ -0,0 +1,21 @@
+#include "checkpoint.hpp"
+#include <cstring>
+
+using namespace exceptions::checkpoint;
+
+#pragma region MissingStateException
+const char *MissingStateException::what() const throw() {
+  std::string s = this->path + " does not contain a training checkpoint.";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion MissingStateException
+#pragma region WriteException
+const char *WriteException::what() const throw() {
+  std::string s = "Failed to write the checkpoint to " + this->path + ".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion WriteException
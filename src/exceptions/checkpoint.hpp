@@ -0,0 +1,21 @@
+#pragma once
+#include <exception>
+#include <string>
+
+namespace exceptions::checkpoint {
+class MissingStateException : public std::exception {
+  std::string path;
+  virtual const char *what() const throw();
+
+public:
+  MissingStateException(const std::string &path) : path(path){};
+};
+
+class WriteException : public std::exception {
+  std::string path;
+  virtual const char *what() const throw();
+
+public:
+  WriteException(const std::string &path) : path(path){};
+};
+} // namespace exceptions::checkpoint
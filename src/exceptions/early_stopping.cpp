@@ -0,0 +1,44 @@
+#include "early_stopping.hpp"
+#include <cstring>
+
+using namespace exceptions::early_stopping;
+
+#pragma region InvalidMetricException
+const char *InvalidMetricException::what() const throw() {
+  std::string s = "Early stopping requires a single value metric. Got: \"" +
+                  this->metric + "\".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidMetricException
+
+#pragma region InvalidPatienceException
+const char *InvalidPatienceException::what() const throw() {
+  std::string s =
+      "Patience must be > 0. Got: " + std::to_string(this->patience) + ".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidPatienceException
+
+#pragma region InvalidMinDeltaException
+const char *InvalidMinDeltaException::what() const throw() {
+  std::string s =
+      "Min delta must be >= 0. Got: " + std::to_string(this->minDelta) + ".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidMinDeltaException
+
+#pragma region UntrackedMetricException
+const char *UntrackedMetricException::what() const throw() {
+  std::string s = "Early stopping requires \"" + this->metric +
+                  "\" to be tracked in the validation metrics.";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion UntrackedMetricException
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+#include <exception>
+#include <string>
+
+namespace exceptions::early_stopping {
+class InvalidMetricException : public std::exception {
+  std::string metric;
+  virtual const char *what() const throw();
+
+public:
+  InvalidMetricException(const std::string &metric) : metric(metric){};
+};
+
+class InvalidPatienceException : public std::exception {
+  int patience;
+  virtual const char *what() const throw();
+
+public:
+  InvalidPatienceException(int patience) : patience(patience){};
+};
+
+class InvalidMinDeltaException : public std::exception {
+  double minDelta;
+  virtual const char *what() const throw();
+
+public:
+  InvalidMinDeltaException(double minDelta) : minDelta(minDelta){};
+};
+
+class UntrackedMetricException : public std::exception {
+  std::string metric;
+  virtual const char *what() const throw();
+
+public:
+  UntrackedMetricException(const std::string &metric) : metric(metric){};
+};
+} // namespace exceptions::early_stopping
@@ -12,4 +12,10 @@ const char *JSONTypeException::what() const throw() {
 const char *JSONArray2DException::what() const throw() {
   return "JSON data should be in the form of a 2D array.";
 }
-#pragma endregion JSONArray2DException
\ No newline at end of file
+#pragma endregion JSONArray2DException
+
+#pragma region JSONArray1DException
+const char *JSONArray1DException::what() const throw() {
+  return "JSON data should be in the form of a 1D array.";
+}
+#pragma endregion JSONArray1DException
\ No newline at end of file
@@ -9,4 +9,8 @@ class JSONTypeException : public std::exception {
 class JSONArray2DException : public std::exception {
   virtual const char *what() const throw();
 };
+
+class JSONArray1DException : public std::exception {
+  virtual const char *what() const throw();
+};
 } // namespace exceptions::json
\ No newline at end of file
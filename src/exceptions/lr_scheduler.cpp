@@ -0,0 +1,25 @@
+#include "lr_scheduler.hpp"
+#include <cstring>
+
+using namespace exceptions::lr_scheduler;
+
+#pragma region InvalidScheduleException
+const char *InvalidScheduleException::what() const throw() {
+  std::string s = "Learning rate schedule \"" + this->schedule +
+                  "\" is not supported. Only constant, step, cosine and "
+                  "one_cycle are supported.";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidScheduleException
+
+#pragma region InvalidParameterException
+const char *InvalidParameterException::what() const throw() {
+  std::string s = "Invalid learning rate schedule " + this->parameter +
+                  ". Got: " + std::to_string(this->value) + ".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidParameterException
\ No newline at end of file
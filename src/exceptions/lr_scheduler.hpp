@@ -0,0 +1,23 @@
+#pragma once
+#include <exception>
+#include <string>
+
+namespace exceptions::lr_scheduler {
+class InvalidScheduleException : public std::exception {
+  std::string schedule;
+  virtual const char *what() const throw();
+
+public:
+  InvalidScheduleException(const std::string &schedule) : schedule(schedule){};
+};
+
+class InvalidParameterException : public std::exception {
+  std::string parameter;
+  double value;
+  virtual const char *what() const throw();
+
+public:
+  InvalidParameterException(const std::string &parameter, double value)
+      : parameter(parameter), value(value){};
+};
+} // namespace exceptions::lr_scheduler
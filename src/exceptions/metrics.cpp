@@ -24,4 +24,54 @@ const char *InvalidDatasetException::what() const throw() {
   std::strcpy(result, s.c_str());
   return result;
 }
-#pragma endregion InvalidDatasetException
\ No newline at end of file
+#pragma endregion InvalidDatasetException
+
+#pragma region MismatchedConfusionMatrixException
+const char *MismatchedConfusionMatrixException::what() const throw() {
+  std::string s = "Cannot merge a confusion matrix of " +
+                  std::to_string(this->otherNumClasses) +
+                  " classes into one of " + std::to_string(this->numClasses) +
+                  " classes.";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion MismatchedConfusionMatrixException
+
+#pragma region InvalidHistoryWidthException
+const char *InvalidHistoryWidthException::what() const throw() {
+  std::string s = "Cannot store " + std::to_string(this->size) +
+                  " values in a metric history of width " +
+                  std::to_string(this->width) + ".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidHistoryWidthException
+
+#pragma region MismatchedAccumulatorException
+const char *MismatchedAccumulatorException::what() const throw() {
+  return "Cannot merge accumulators of different metrics.";
+}
+#pragma endregion MismatchedAccumulatorException
+
+#pragma region InvalidTopKException
+const char *InvalidTopKException::what() const throw() {
+  std::string s =
+      "k must be > 0 for top k accuracy. Got: " + std::to_string(this->k) + ".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidTopKException
+
+#pragma region InvalidNumberOfBinsException
+const char *InvalidNumberOfBinsException::what() const throw() {
+  std::string s =
+      "The number of bins must be > 0. Got: " + std::to_string(this->bins) +
+      ".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidNumberOfBinsException
\ No newline at end of file
@@ -18,4 +18,42 @@ public:
   InvalidDatasetException(int predictionSize, int actualSize)
       : predictionSize(predictionSize), actualSize(actualSize){};
 };
+
+class MismatchedConfusionMatrixException : public std::exception {
+  int numClasses, otherNumClasses;
+  virtual const char *what() const throw();
+
+public:
+  MismatchedConfusionMatrixException(int numClasses, int otherNumClasses)
+      : numClasses(numClasses), otherNumClasses(otherNumClasses){};
+};
+
+class InvalidHistoryWidthException : public std::exception {
+  int width, size;
+  virtual const char *what() const throw();
+
+public:
+  InvalidHistoryWidthException(int width, int size)
+      : width(width), size(size){};
+};
+
+class MismatchedAccumulatorException : public std::exception {
+  virtual const char *what() const throw();
+};
+
+class InvalidTopKException : public std::exception {
+  int k;
+  virtual const char *what() const throw();
+
+public:
+  InvalidTopKException(int k) : k(k){};
+};
+
+class InvalidNumberOfBinsException : public std::exception {
+  int bins;
+  virtual const char *what() const throw();
+
+public:
+  InvalidNumberOfBinsException(int bins) : bins(bins){};
+};
 } // namespace exceptions::metrics
\ No newline at end of file
@@ -0,0 +1,14 @@
+#include "metrics_logger.hpp"
+#include <cstring>
+
+using namespace exceptions::metrics_logger;
+
+#pragma region InvalidExtensionException
+const char *InvalidExtensionException::what() const throw() {
+  std::string s = "Metrics file format \"" + this->extension +
+                  "\" is not supported. Only .jsonl and .prom are supported.";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidExtensionException
\ No newline at end of file
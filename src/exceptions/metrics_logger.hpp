@@ -0,0 +1,14 @@
+#pragma once
+#include <exception>
+#include <string>
+
+namespace exceptions::metrics_logger {
+class InvalidExtensionException : public std::exception {
+  std::string extension;
+  virtual const char *what() const throw();
+
+public:
+  InvalidExtensionException(const std::string &extension)
+      : extension(extension){};
+};
+} // namespace exceptions::metrics_logger
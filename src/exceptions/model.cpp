@@ -64,4 +64,45 @@ const char *InvalidPlottingMetricException::what() const throw() {
   std::strcpy(result, s.c_str());
   return result;
 }
-#pragma endregion InvalidPlottingMetricException
\ No newline at end of file
+#pragma endregion InvalidPlottingMetricException
+
+#pragma region MissingStreamingMetricException
+const char *MissingStreamingMetricException::what() const throw() {
+  std::string s = "No accumulator was given for the streaming metric \"" +
+                  this->metric + "\".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion MissingStreamingMetricException
+
+#pragma region InvalidLayerSizeException
+const char *InvalidLayerSizeException::what() const throw() {
+  std::string s =
+      "Layer sizes must be > 0. Got: " + std::to_string(this->size) + ".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidLayerSizeException
+
+#pragma region MismatchedOutputSizeException
+const char *MismatchedOutputSizeException::what() const throw() {
+  std::string s = "The output layer size must match the " +
+                  std::to_string(this->outputs) +
+                  " outputs. Got: " + std::to_string(this->size) + ".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion MismatchedOutputSizeException
+#pragma region MismatchedInputSizeException
+const char *MismatchedInputSizeException::what() const throw() {
+  std::string s = "The model takes " + std::to_string(this->inputs) +
+                  " inputs but the images have " +
+                  std::to_string(this->features) + " features.";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion MismatchedInputSizeException
@@ -54,4 +54,39 @@ class InvalidPlottingMetricException : public std::exception {
 public:
   InvalidPlottingMetricException(const std::string &metric) : metric(metric){};
 };
+
+class MissingStreamingMetricException : public std::exception {
+  std::string metric;
+  virtual const char *what() const throw();
+
+public:
+  MissingStreamingMetricException(const std::string &metric)
+      : metric(metric){};
+};
+
+class InvalidLayerSizeException : public std::exception {
+  int size;
+  virtual const char *what() const throw();
+
+public:
+  InvalidLayerSizeException(int size) : size(size){};
+};
+
+class MismatchedOutputSizeException : public std::exception {
+  int size, outputs;
+  virtual const char *what() const throw();
+
+public:
+  MismatchedOutputSizeException(int size, int outputs)
+      : size(size), outputs(outputs){};
+};
+
+class MismatchedInputSizeException : public std::exception {
+  int inputs, features;
+  virtual const char *what() const throw();
+
+public:
+  MismatchedInputSizeException(int inputs, int features)
+      : inputs(inputs), features(features){};
+};
 } // namespace exceptions::model
\ No newline at end of file
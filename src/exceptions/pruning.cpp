@@ -0,0 +1,36 @@
+#include "pruning.hpp"
+#include <cstring>
+
+using namespace exceptions::pruning;
+
+#pragma region InvalidCriterionException
+const char *InvalidCriterionException::what() const throw() {
+  std::string s = "Invalid pruning criterion \"" + this->criterion +
+                  "\". Expected weight or activation.";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidCriterionException
+
+#pragma region InvalidSparsityException
+const char *InvalidSparsityException::what() const throw() {
+  std::string s = "Sparsity must be >= 0 and < 1. Got: " +
+                  std::to_string(this->sparsity) + ".";
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidSparsityException
+
+#pragma region InvalidCalibrationBatchesException
+const char *InvalidCalibrationBatchesException::what() const throw() {
+  std::string s =
+      "The number of calibration batches must be greater than or equal 1, "
+      "got " +
+      std::to_string(this->batches);
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidCalibrationBatchesException
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include <exception>
+#include <string>
+
+namespace exceptions::pruning {
+class InvalidCriterionException : public std::exception {
+  std::string criterion;
+  virtual const char *what() const throw();
+
+public:
+  InvalidCriterionException(const std::string &criterion)
+      : criterion(criterion){};
+};
+
+class InvalidSparsityException : public std::exception {
+  double sparsity;
+  virtual const char *what() const throw();
+
+public:
+  InvalidSparsityException(double sparsity) : sparsity(sparsity){};
+};
+
+class InvalidCalibrationBatchesException : public std::exception {
+  int batches;
+  virtual const char *what() const throw();
+
+public:
+  InvalidCalibrationBatchesException(int batches) : batches(batches){};
+};
+} // namespace exceptions::pruning
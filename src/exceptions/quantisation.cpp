@@ -0,0 +1,16 @@
+#include "quantisation.hpp"
+#include <cstring>
+
+using namespace exceptions::quantisation;
+
+#pragma region InvalidCalibrationBatchesException
+const char *InvalidCalibrationBatchesException::what() const throw() {
+  std::string s =
+      "The number of calibration batches must be greater than or equal 1, "
+      "got " +
+      std::to_string(this->batches);
+  char *result = new char[s.length() + 1];
+  std::strcpy(result, s.c_str());
+  return result;
+}
+#pragma endregion InvalidCalibrationBatchesException
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+#include <exception>
+#include <string>
+
+namespace exceptions::quantisation {
+class InvalidCalibrationBatchesException : public std::exception {
+  int batches;
+  virtual const char *what() const throw();
+
+public:
+  InvalidCalibrationBatchesException(int batches) : batches(batches){};
+};
+} // namespace exceptions::quantisation
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include "sweep.hpp"
+
+using namespace exceptions::sweep;
+
+#pragma region EmptyDatasetException
+const char *EmptyDatasetException::what() const throw() {
+  return "Sweeps require at least one training sample.";
+}
+#pragma endregion EmptyDatasetException
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+#include <exception>
+#include <string>
+
+namespace exceptions::sweep {
+class EmptyDatasetException : public std::exception {
+  virtual const char *what() const throw();
+};
+} // namespace exceptions::sweep
@@ -1,11 +1,14 @@
 #include "image_loader.hpp"
 #include "exceptions/image_loader.hpp"
 #include "utils/image.hpp"
+#include "utils/math.hpp"
 #include "utils/matrix.hpp"
 #include "utils/path.hpp"
+#include "utils/trace.hpp"
 #include <Eigen/Dense>
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <random>
 #include <stdexcept>
 
@@ -25,9 +28,21 @@ DatasetBatcher::DatasetBatcher(
   if (batchSize < 1) {
     throw exceptions::loader::InvalidBatchSizeException(batchSize);
   }
+  if (kwargs.samples > 0) {
+    std::vector<int> labels;
+    for (const std::filesystem::path &path : this->data) {
+      labels.push_back(this->getLabel(path));
+    }
+    std::vector<std::filesystem::path> sample;
+    for (int i :
+         utils::math::stratifiedSample(labels, kwargs.samples, kwargs.seed)) {
+      sample.push_back(this->data[i]);
+    }
+    this->data = std::move(sample);
+  }
   if (kwargs.shuffle) {
     std::shuffle(this->data.begin(), this->data.end(),
-                 std::default_random_engine{});
+                 std::default_random_engine{kwargs.seed});
   }
 }
 
@@ -39,6 +54,13 @@ DatasetBatcher::DatasetBatcher(
                      KeywordArgs()) {}
 #pragma endregion Constructor
 
+#pragma region Labels
+int DatasetBatcher::getLabel(const std::filesystem::path &path) const {
+  std::string label = *std::filesystem::relative(path, this->root).begin();
+  return this->classesToNum.at(label);
+}
+#pragma endregion Labels
+
 #pragma region Iterators
 DatasetBatcher::Iterator DatasetBatcher::begin() const {
   return Iterator(this, 0);
@@ -63,6 +85,7 @@ minibatch DatasetBatcher::operator[](int batch) const {
   if (batch >= this->size() || batch < 0) {
     throw std::out_of_range("Batch is out of range.");
   }
+  utils::trace::ScopedEvent event("Decode batch", "loader");
 
   Eigen::MatrixXd
       result; // Set dimensions later when the number of columns is known.
@@ -87,8 +110,7 @@ minibatch DatasetBatcher::operator[](int batch) const {
     result.row(i - batch * this->batchSize) = image.row(0);
 
     // Process label
-    std::string label = *std::filesystem::relative(path, this->root).begin();
-    labels.push_back(this->classesToNum.at(label));
+    labels.push_back(this->getLabel(path));
   }
 
   return std::make_pair(result, labels);
@@ -177,4 +199,99 @@ ImageLoader::operator()(std::string dataset, int batchSize,
   return this->getBatcher(dataset, batchSize, kwargs);
 }
 #pragma endregion Builtins
-#pragma endregion Image loader
\ No newline at end of file
+#pragma endregion Image loader
+
+#pragma region In memory
+#pragma region In memory dataset batcher
+InMemoryDatasetBatcher::InMemoryDatasetBatcher(
+    std::shared_ptr<const minibatch> samples, int batchSize,
+    const KeywordArgs &kwargs)
+    : samples(std::move(samples)), batchSize(batchSize),
+      dropLast(kwargs.dropLast) {
+  if (batchSize < 1) {
+    throw exceptions::loader::InvalidBatchSizeException(batchSize);
+  }
+  if (kwargs.samples > 0) {
+    this->indices = utils::math::stratifiedSample(this->samples->second,
+                                                  kwargs.samples, kwargs.seed);
+  } else {
+    this->indices = std::vector<int>(this->samples->second.size());
+    std::iota(this->indices.begin(), this->indices.end(), 0);
+  }
+  if (kwargs.shuffle) {
+    std::shuffle(this->indices.begin(), this->indices.end(),
+                 std::default_random_engine{kwargs.seed});
+  }
+}
+
+int InMemoryDatasetBatcher::size() const {
+  return (this->indices.size() + (this->dropLast ? 0 : this->batchSize - 1)) /
+         this->batchSize;
+}
+
+minibatch InMemoryDatasetBatcher::operator[](int batch) const {
+  if (batch >= this->size() || batch < 0) {
+    throw std::out_of_range("Batch is out of range.");
+  }
+
+  int start = batch * this->batchSize,
+      stop = std::min((int)this->indices.size(), start + this->batchSize);
+  const auto &[data, labels] = *this->samples;
+  Eigen::MatrixXd result(stop - start, data.cols());
+  std::vector<int> resultLabels;
+  for (int i = start; i < stop; ++i) {
+    result.row(i - start) = data.row(this->indices[i]);
+    resultLabels.push_back(labels[this->indices[i]]);
+  }
+  return std::make_pair(result, resultLabels);
+}
+#pragma endregion In memory dataset batcher
+
+#pragma region In memory image loader
+/*
+  Decode every sample of the dataset, a batch at a time so only the decoded
+  samples and a single batch are in memory at once.
+*/
+static std::shared_ptr<const minibatch> decode(const ImageLoader &loader,
+                                               const std::string &dataset) {
+  const int batchSize = 256;
+  std::shared_ptr<DatasetBatcher> batcher =
+      loader(dataset, batchSize, {.shuffle = false});
+  std::vector<minibatch> batches;
+  int rows = 0;
+  for (int i = 0; i < batcher->size(); ++i) {
+    batches.push_back((*batcher)[i]);
+    rows += batches.back().first.rows();
+  }
+
+  Eigen::MatrixXd data(rows, batches.empty() ? 0 : batches[0].first.cols());
+  std::vector<int> labels;
+  labels.reserve(rows);
+  int row = 0;
+  for (auto &[batchData, batchLabels] : batches) {
+    data.middleRows(row, batchData.rows()) = batchData;
+    row += batchData.rows();
+    labels.insert(labels.end(), batchLabels.begin(), batchLabels.end());
+  }
+  return std::make_shared<const minibatch>(std::move(data), std::move(labels));
+}
+
+InMemoryImageLoader::InMemoryImageLoader(const ImageLoader &loader) {
+  utils::trace::ScopedEvent event("Decode dataset", "loader");
+  this->classes = loader.getClasses();
+  this->trainSamples = decode(loader, "train");
+  this->testSamples = decode(loader, "test");
+}
+
+std::shared_ptr<DatasetBatcher> InMemoryImageLoader::getBatcher(
+    std::string dataset, int batchSize,
+    const DatasetBatcher::KeywordArgs &kwargs) const {
+  if (dataset != "train" && dataset != "test") {
+    throw exceptions::loader::InvalidDatasetException(dataset);
+  }
+  return std::make_shared<InMemoryDatasetBatcher>(
+      dataset == "train" ? this->trainSamples : this->testSamples, batchSize,
+      kwargs);
+}
+#pragma endregion In memory image loader
+#pragma endregion In memory
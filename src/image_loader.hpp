@@ -4,6 +4,7 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <random>
 #include <stddef.h>
 #include <string>
 #include <unordered_map>
@@ -68,9 +69,20 @@ class DatasetBatcher {
   int batchSize;
   bool dropLast;
 
+  /*
+    Get the class number of the file.
+  */
+  int getLabel(const std::filesystem::path &path) const;
+
 public:
+  /*
+    When samples is positive, only a stratified sample of that many files is
+    kept, drawn with the seed.
+  */
   struct KeywordArgs {
     bool shuffle = true, dropLast = false;
+    unsigned int seed = std::default_random_engine::default_seed;
+    int samples = 0;
   };
 
   using Iterator = DatasetIterator<DatasetBatcher>;
@@ -181,4 +193,41 @@ public:
 #pragma endregion Builtins
 };
 #pragma endregion Image loader
+
+#pragma region In memory
+/*
+  Batches samples that are already decoded, sharing the samples with every
+  other batcher of the same dataset rather than copying them.
+*/
+class InMemoryDatasetBatcher : public DatasetBatcher {
+  std::shared_ptr<const minibatch> samples;
+  std::vector<int> indices;
+  int batchSize;
+  bool dropLast;
+
+public:
+  InMemoryDatasetBatcher(std::shared_ptr<const minibatch> samples,
+                         int batchSize, const KeywordArgs &kwargs);
+
+  int size() const override;
+  minibatch operator[](int i) const override;
+};
+
+/*
+  Decodes every sample of the loader once, keeping the samples in memory to be
+  shared read-only by every batcher it returns, such as the batchers of
+  models trained concurrently on the same dataset.
+*/
+class InMemoryImageLoader : public ImageLoader {
+  std::shared_ptr<const minibatch> trainSamples, testSamples;
+
+public:
+  InMemoryImageLoader(const ImageLoader &loader);
+
+  std::shared_ptr<DatasetBatcher>
+  getBatcher(std::string dataset, int batchSize,
+             const DatasetBatcher::KeywordArgs &kwargs =
+                 DatasetBatcher::KeywordArgs()) const override;
+};
+#pragma endregion In memory
 } // namespace loader
\ No newline at end of file
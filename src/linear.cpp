@@ -5,6 +5,7 @@
 #include "exceptions/eigen.hpp"
 #include "exceptions/load.hpp"
 #include "utils/matrix.hpp"
+#include "utils/memory.hpp"
 #include <Eigen/Dense>
 #include <Eigen/src/Core/Matrix.h>
 #include <algorithm>
@@ -16,6 +17,34 @@
 
 using namespace linear;
 
+#pragma region Helpers
+/*
+  The largest batch multiplied one row at a time.
+
+  Eigen packs both operands of a matrix-matrix product into blocks before
+  multiplying them, which dominates the cost for small batches. Matrix-vector
+  products read the weight in place instead.
+*/
+static const int SMALL_BATCH_SIZE = 8;
+
+/*
+  Multiply the rows of the input by the matrix.
+*/
+template <typename T>
+static Eigen::MatrixXd multiplyRows(const Eigen::MatrixXd &input,
+                                    const Eigen::MatrixBase<T> &matrix) {
+  if (input.rows() > SMALL_BATCH_SIZE) {
+    return input * matrix;
+  }
+
+  Eigen::MatrixXd result(input.rows(), matrix.cols());
+  for (int i = 0; i < input.rows(); ++i) {
+    result.row(i).noalias() = input.row(i) * matrix;
+  }
+  return result;
+}
+#pragma endregion Helpers
+
 #pragma region Constructor
 Linear::Linear(int inChannels, int outChannels, const std::string &activation)
     : inChannels(inChannels), outChannels(outChannels) {
@@ -33,6 +62,17 @@ Linear::Linear(int inChannels, int outChannels, const std::string &activation)
   this->bias =
       Eigen::VectorXd::Random(outChannels).transpose() * distributionRange;
 }
+
+Linear::Linear(Eigen::MatrixXd weight, Eigen::VectorXd bias,
+               const std::string &activation)
+    : weight(std::move(weight)), bias(std::move(bias)),
+      inChannels(this->weight.cols()), outChannels(this->weight.rows()) {
+  if (this->bias.rows() != this->outChannels) {
+    throw exceptions::eigen::InvalidShapeException(
+        Eigen::VectorXd(this->outChannels), this->bias);
+  }
+  this->setActivation(activation);
+}
 #pragma endregion Constructor
 
 #pragma region Properties
@@ -69,6 +109,15 @@ void Linear::setBias(Eigen::VectorXd bias) {
 }
 #pragma endregion Bias
 
+#pragma region Parameters
+void Linear::copyParametersTo(Linear &other) const {
+  other.weight = this->weight;
+  other.bias = this->bias;
+  other.inChannels = this->inChannels;
+  other.outChannels = this->outChannels;
+}
+#pragma endregion Parameters
+
 #pragma region Activation function
 std::shared_ptr<activation_functions::ActivationFunction>
 Linear::getActivation() const {
@@ -85,6 +134,18 @@ void Linear::setActivation(std::string activation) {
   }
 }
 #pragma endregion Activation function
+
+#pragma region Memory
+std::size_t Linear::getParameterSize() const {
+  return utils::memory::getSize(this->weight) +
+         utils::memory::getSize(this->bias);
+}
+
+std::size_t Linear::getCacheSize() const {
+  return utils::memory::getSize(this->input) +
+         this->activationFunction->getCacheSize();
+}
+#pragma endregion Memory
 #pragma endregion Properties
 
 #pragma region Load
@@ -93,15 +154,9 @@ Linear Linear::fromJson(const json &values) {
     throw exceptions::load::InvalidClassAttributeValue();
   }
 
-  Eigen::MatrixXd weight = utils::matrix::fromJson(values["weight"]),
-                  bias = utils::matrix::fromJson(json::array({values["bias"]}))
-                             .transpose();
-  int outChannels = weight.rows(), inChannels = weight.cols();
-  Linear layer(inChannels, outChannels);
-  layer.setWeight(weight);
-  layer.setBias(bias);
-  layer.setActivation(values["activation_function"]);
-  return layer;
+  return Linear(utils::matrix::fromJson(values["weight"]),
+                utils::matrix::vectorFromJson(values["bias"]),
+                values["activation_function"].get<std::string>());
 }
 #pragma endregion Load
 
@@ -119,10 +174,16 @@ json Linear::toJson() const {
 #pragma region Forward pass
 Eigen::MatrixXd Linear::forward(const Eigen::MatrixXd &input) {
   this->input = this->eval ? nullptr : std::make_shared<Eigen::MatrixXd>(input);
-  Eigen::MatrixXd output = input * this->weight.transpose();
+  Eigen::MatrixXd output = multiplyRows(input, this->weight.transpose());
   output.rowwise() += this->bias.transpose();
   return (*this->activationFunction)(output);
 }
+
+Eigen::MatrixXd Linear::infer(const Eigen::MatrixXd &input) const {
+  Eigen::MatrixXd output = multiplyRows(input, this->weight.transpose());
+  output.rowwise() += this->bias.transpose();
+  return this->activationFunction->infer(output);
+}
 #pragma endregion Forward pass
 
 #pragma region Backward pass
@@ -142,15 +203,21 @@ Linear::backward(const Eigen::MatrixXd &grad) {
                               this->activationFunction->backward().array(),
                   weightGrad = totalGrad.transpose() * *this->input,
                   biasGrad = totalGrad.colwise().sum().transpose(),
-                  inputGrad = totalGrad * this->weight;
+                  inputGrad = multiplyRows(totalGrad, this->weight);
   return std::make_tuple(inputGrad, weightGrad, biasGrad);
 }
 
+void Linear::applyGradients(const Eigen::MatrixXd &weightGrad,
+                            const Eigen::MatrixXd &biasGrad,
+                            const double learningRate) {
+  this->weight -= learningRate * weightGrad;
+  this->bias -= learningRate * biasGrad;
+}
+
 Eigen::MatrixXd Linear::update(const Eigen::MatrixXd &grad,
                                const double learningRate) {
   auto [inputGrad, weightGrad, biasGrad] = this->backward(grad);
-  this->weight -= learningRate * weightGrad;
-  this->bias -= learningRate * biasGrad;
+  this->applyGradients(weightGrad, biasGrad, learningRate);
   return inputGrad;
 }
 #pragma endregion Backward pass
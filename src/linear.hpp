@@ -1,5 +1,6 @@
 #pragma once
 #include <Eigen/Dense>
+#include <cstddef>
 #include <memory>
 #include <nlohmann/json_fwd.hpp>
 #include <string>
@@ -29,6 +30,12 @@ public:
   int inChannels, outChannels;
   Linear(int inChannels, int outChannels,
          const std::string &activation = "NoActivation");
+  /*
+    Create a layer that takes ownership of the given parameters, skipping the
+    random initialisation.
+  */
+  Linear(Eigen::MatrixXd weight, Eigen::VectorXd bias,
+         const std::string &activation = "NoActivation");
 
 #pragma region Properties
 #pragma region Evaluation mode
@@ -64,6 +71,15 @@ public:
   void setBias(Eigen::VectorXd bias);
 #pragma endregion Bias
 
+#pragma region Parameters
+  /*
+    Copy the layer's weight and bias into the other layer, reusing the other
+    layer's memory when the shapes match. The other layer keeps its activation
+    function.
+  */
+  void copyParametersTo(Linear &other) const;
+#pragma endregion Parameters
+
 #pragma region Activation function
   /*
     Get the layer's activation function.
@@ -75,6 +91,18 @@ public:
   */
   void setActivation(std::string activation_function);
 #pragma endregion Activation function
+
+#pragma region Memory
+  /*
+    Get the number of bytes held by the layer's weight and bias.
+  */
+  std::size_t getParameterSize() const;
+  /*
+    Get the number of bytes held by the inputs saved for the backward pass,
+    including the activation function's.
+  */
+  std::size_t getCacheSize() const;
+#pragma endregion Memory
 #pragma endregion Properties
 
 #pragma region Load
@@ -102,6 +130,12 @@ public:
     Perform the forward pass for the layer.
   */
   Eigen::MatrixXd forward(const Eigen::MatrixXd &input);
+
+  /*
+    Perform the forward pass for the layer without saving any inputs for the
+    backward pass, allowing it to be called concurrently.
+  */
+  Eigen::MatrixXd infer(const Eigen::MatrixXd &input) const;
 #pragma endregion Forward pass
 
 #pragma region Backward pass
@@ -110,6 +144,12 @@ public:
   */
   std::tuple<Eigen::MatrixXd, Eigen::MatrixXd, Eigen::MatrixXd>
   backward(const Eigen::MatrixXd &grad);
+  /*
+    Step the parameters of the layer against the given gradients.
+  */
+  void applyGradients(const Eigen::MatrixXd &weightGrad,
+                      const Eigen::MatrixXd &biasGrad,
+                      const double learningRate);
   /*
     Update the parameters of the layer.
   */
@@ -0,0 +1,92 @@
+#include "lr_scheduler.hpp"
+#include "exceptions/lr_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+using namespace lr_scheduler;
+
+Schedule lr_scheduler::scheduleFromString(const std::string &schedule) {
+  if (schedule == "constant") {
+    return Schedule::CONSTANT;
+  } else if (schedule == "step") {
+    return Schedule::STEP;
+  } else if (schedule == "cosine") {
+    return Schedule::COSINE;
+  } else if (schedule == "one_cycle") {
+    return Schedule::ONE_CYCLE;
+  }
+  throw exceptions::lr_scheduler::InvalidScheduleException(schedule);
+}
+
+#pragma region Scheduler
+Scheduler::Scheduler(double learningRate, int epochs, int batchesPerEpoch,
+                     const KeywordArgs &kwargs)
+    : learningRate(learningRate), kwargs(kwargs) {
+  if (kwargs.warmupEpochs < 0) {
+    throw exceptions::lr_scheduler::InvalidParameterException(
+        "warmupEpochs", kwargs.warmupEpochs);
+  }
+  if (kwargs.stepEpochs < 1) {
+    throw exceptions::lr_scheduler::InvalidParameterException(
+        "stepEpochs", kwargs.stepEpochs);
+  }
+  if (kwargs.gamma <= 0) {
+    throw exceptions::lr_scheduler::InvalidParameterException("gamma",
+                                                              kwargs.gamma);
+  }
+  if (kwargs.minLearningRate < 0 || kwargs.minLearningRate > learningRate) {
+    throw exceptions::lr_scheduler::InvalidParameterException(
+        "minLearningRate", kwargs.minLearningRate);
+  }
+
+  this->totalSteps = std::max(epochs * batchesPerEpoch, 1);
+  this->warmupSteps = std::min(
+      (int)std::round(kwargs.warmupEpochs * batchesPerEpoch), this->totalSteps);
+  this->stepSteps = std::max(kwargs.stepEpochs * batchesPerEpoch, 1);
+}
+
+Scheduler::Scheduler(double learningRate, int epochs, int batchesPerEpoch)
+    : Scheduler(learningRate, epochs, batchesPerEpoch, KeywordArgs()) {}
+
+bool Scheduler::isConstant() const {
+  return this->kwargs.schedule == Schedule::CONSTANT && this->warmupSteps == 0;
+}
+
+double Scheduler::operator()(int step) const {
+  step = std::clamp(step, 0, this->totalSteps - 1);
+  if (step < this->warmupSteps) {
+    return this->learningRate * (step + 1) / this->warmupSteps;
+  }
+
+  // The schedule starts once the warmup ends
+  step -= this->warmupSteps;
+  int steps = std::max(this->totalSteps - this->warmupSteps, 1);
+  double maxLearningRate = this->learningRate,
+         minLearningRate = this->kwargs.minLearningRate;
+  auto anneal = [&](double progress) {
+    return minLearningRate + (maxLearningRate - minLearningRate) *
+                                 (1 + std::cos(std::numbers::pi * progress)) /
+                                 2;
+  };
+
+  switch (this->kwargs.schedule) {
+  case Schedule::STEP:
+    return maxLearningRate *
+           std::pow(this->kwargs.gamma, step / this->stepSteps);
+  case Schedule::COSINE:
+    return anneal((double)step / steps);
+  case Schedule::ONE_CYCLE: {
+    double initialLearningRate = maxLearningRate / 25;
+    int peak = std::max((int)(steps * 0.3), 1);
+    if (step < peak) {
+      return initialLearningRate +
+             (maxLearningRate - initialLearningRate) * step / peak;
+    }
+    return anneal((double)(step - peak) / std::max(steps - peak, 1));
+  }
+  default:
+    return maxLearningRate;
+  }
+}
+#pragma endregion Scheduler
@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+
+namespace lr_scheduler {
+/*
+  The shapes the learning rate can follow over a run.
+
+  Schedules:
+          - CONSTANT -- the learning rate throughout
+          - STEP -- the learning rate decayed by gamma every stepEpochs epochs
+          - COSINE -- annealed from the learning rate to the minimum learning
+          rate along half a cosine
+          - ONE_CYCLE -- raised linearly from a 25th of the learning rate to
+          the learning rate over the first 30% of the run, then annealed to
+          the minimum learning rate along half a cosine
+*/
+enum class Schedule { CONSTANT, STEP, COSINE, ONE_CYCLE };
+
+/*
+  Get the schedule from its name, being constant, step, cosine or one_cycle.
+*/
+Schedule scheduleFromString(const std::string &schedule);
+
+/*
+  Gets the learning rate of each minibatch of a run.
+
+  When warmupEpochs is positive, the learning rate is first raised linearly
+  from 0 over that many epochs, and the schedule follows over the remaining
+  epochs. Epochs may be fractional, and are converted to minibatches so the
+  learning rate changes every minibatch.
+*/
+class Scheduler {
+public:
+  struct KeywordArgs {
+    Schedule schedule = Schedule::CONSTANT;
+    double warmupEpochs = 0;
+    int stepEpochs = 1;
+    double gamma = 0.1;
+    double minLearningRate = 0;
+  };
+
+private:
+  double learningRate;
+  int totalSteps, warmupSteps, stepSteps;
+  KeywordArgs kwargs;
+
+public:
+  Scheduler(double learningRate, int epochs, int batchesPerEpoch,
+            const KeywordArgs &kwargs);
+  Scheduler(double learningRate, int epochs, int batchesPerEpoch);
+
+  /*
+    Whether the learning rate changes over the run.
+  */
+  bool isConstant() const;
+
+  /*
+    Get the learning rate of the minibatch, counted from 0 at the start of the
+    run.
+  */
+  double operator()(int step) const;
+};
+} // namespace lr_scheduler
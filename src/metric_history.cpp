@@ -0,0 +1,71 @@
+#include "metric_history.hpp"
+#include "exceptions/metrics.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+using namespace metrics;
+
+MetricHistory::MetricHistory(std::vector<float> values, int width)
+    : values(std::move(values)), width(width) {
+  if (width < 0 || (width == 0 && !this->values.empty()) ||
+      (width > 0 && this->values.size() % width != 0)) {
+    throw exceptions::metrics::InvalidHistoryWidthException(
+        width, this->values.size());
+  }
+}
+
+#pragma region Properties
+int MetricHistory::size() const {
+  return this->width == 0 ? 0 : this->values.size() / this->width;
+}
+
+bool MetricHistory::empty() const { return this->values.empty(); }
+
+int MetricHistory::getWidth() const { return this->width; }
+
+std::span<const float> MetricHistory::getValues() const { return this->values; }
+
+std::size_t MetricHistory::getSize() const {
+  return this->values.size() * sizeof(float);
+}
+#pragma endregion Properties
+
+#pragma region Append
+void MetricHistory::reserve(int epochs) {
+  this->values.reserve(epochs * std::max(this->width, 1));
+}
+
+void MetricHistory::push_back(float value) {
+  this->push_back(std::span<const float>(&value, 1));
+}
+
+void MetricHistory::push_back(std::span<const float> values) {
+  if (this->width == 0 && !values.empty()) {
+    this->width = values.size();
+  }
+  if (values.size() != this->width) {
+    throw exceptions::metrics::InvalidHistoryWidthException(this->width,
+                                                            values.size());
+  }
+  this->values.insert(this->values.end(), values.begin(), values.end());
+}
+#pragma endregion Append
+
+#pragma region Builtins
+std::span<const float> MetricHistory::operator[](int epoch) const {
+  if (epoch < 0 || epoch >= this->size()) {
+    throw std::out_of_range("Epoch is out of range.");
+  }
+  return std::span<const float>(this->values).subspan(epoch * this->width,
+                                                      this->width);
+}
+
+std::span<const float> MetricHistory::back() const {
+  return (*this)[this->size() - 1];
+}
+
+bool MetricHistory::operator==(const MetricHistory &other) const {
+  return this->width == other.width && this->values == other.values;
+}
+#pragma endregion Builtins
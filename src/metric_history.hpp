@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace metrics {
+/*
+  The history of a metric, with the values of every epoch stored in one
+  contiguous buffer of epochs x width values. The width is 1 for single value
+  metrics and the number of classes for per-class metrics, and is set by the
+  first epoch added.
+*/
+class MetricHistory {
+  std::vector<float> values;
+  int width = 0;
+
+public:
+  MetricHistory(){};
+  MetricHistory(std::vector<float> values, int width);
+
+#pragma region Properties
+  /*
+    Get the number of epochs in the history.
+  */
+  int size() const;
+
+  /*
+    Whether the history has no epochs.
+  */
+  bool empty() const;
+
+  /*
+    Get the number of values per epoch.
+  */
+  int getWidth() const;
+
+  /*
+    Get a view of the values of every epoch, in epoch order.
+  */
+  std::span<const float> getValues() const;
+
+  /*
+    Get the number of bytes held by the values.
+  */
+  std::size_t getSize() const;
+#pragma endregion Properties
+
+#pragma region Append
+  /*
+    Reserve space for the given number of epochs.
+  */
+  void reserve(int epochs);
+
+  /*
+    Add the value of a single value metric for the next epoch.
+  */
+  void push_back(float value);
+
+  /*
+    Add the values of the metric for the next epoch.
+  */
+  void push_back(std::span<const float> values);
+#pragma endregion Append
+
+#pragma region Builtins
+  /*
+    Get a view of the values of the epoch (0-based).
+  */
+  std::span<const float> operator[](int epoch) const;
+
+  /*
+    Get a view of the values of the latest epoch.
+  */
+  std::span<const float> back() const;
+
+  bool operator==(const MetricHistory &other) const;
+#pragma endregion Builtins
+};
+} // namespace metrics
@@ -2,6 +2,7 @@
 #include "exceptions/metrics.hpp"
 #include <Eigen/Dense>
 #include <algorithm>
+#include <cmath>
 
 using namespace metrics;
 
@@ -25,6 +26,33 @@ void metrics::addToConfusionMatrix(Eigen::MatrixXi &confusionMatrix,
     confusionMatrix(predictions[i], actual[i])++;
   }
 }
+
+void metrics::addToConfusionMatrix(Eigen::MatrixXi &confusionMatrix,
+                                   const Eigen::MatrixXd &logits,
+                                   std::span<const int> actual) {
+  if (logits.rows() != actual.size()) {
+    throw exceptions::metrics::InvalidDatasetException(logits.rows(),
+                                                       actual.size());
+  }
+
+  // Softmax keeps the order of the logits, so the largest logit is the
+  // prediction
+  for (int i = 0; i < logits.rows(); ++i) {
+    int prediction;
+    logits.row(i).maxCoeff(&prediction);
+    confusionMatrix(prediction, actual[i])++;
+  }
+}
+
+void metrics::mergeConfusionMatrix(Eigen::MatrixXi &confusionMatrix,
+                                   const Eigen::MatrixXi &other) {
+  if (confusionMatrix.rows() != other.rows() ||
+      confusionMatrix.cols() != other.cols()) {
+    throw exceptions::metrics::MismatchedConfusionMatrixException(
+        confusionMatrix.rows(), other.rows());
+  }
+  confusionMatrix += other;
+}
 #pragma endregion Confusion matrix
 
 #pragma region Metrics
@@ -63,4 +91,17 @@ std::vector<float> metrics::f1Score(const Eigen::MatrixXi &confusionMatrix) {
                                            });
   return std::vector<float>(result.data(), result.data() + result.size());
 }
+
+std::pair<float, float>
+metrics::accuracyInterval(const Eigen::MatrixXi &confusionMatrix, double z) {
+  double n = confusionMatrix.sum();
+  if (n == 0) {
+    return {0, 1};
+  }
+  double p = confusionMatrix.diagonal().sum() / n, z2 = z * z,
+         denominator = 1 + z2 / n, centre = (p + z2 / (2 * n)) / denominator,
+         margin = z * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n)) /
+                  denominator;
+  return {std::max(0.0, centre - margin), std::min(1.0, centre + margin)};
+}
 #pragma endregion Metrics
\ No newline at end of file
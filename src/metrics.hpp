@@ -1,9 +1,11 @@
 #pragma once
 #include <Eigen/Dense>
 #include <functional>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -21,6 +23,22 @@ Eigen::MatrixXi getNewConfusionMatrix(int numClasses);
 void addToConfusionMatrix(Eigen::MatrixXi &confusionMatrix,
                           const std::vector<int> &predictions,
                           const std::vector<int> &actual);
+
+/*
+  Add the predictions of the logits to the given confusion matrix, taking the
+  most likely class of each row in the same pass without allocating.
+*/
+void addToConfusionMatrix(Eigen::MatrixXi &confusionMatrix,
+                          const Eigen::MatrixXd &logits,
+                          std::span<const int> actual);
+
+/*
+  Add the counts of the other confusion matrix to the given confusion matrix,
+  such as to merge the confusion matrices accumulated separately by each
+  thread.
+*/
+void mergeConfusionMatrix(Eigen::MatrixXi &confusionMatrix,
+                          const Eigen::MatrixXi &other);
 #pragma endregion Confusion matrix
 
 #pragma region Metrics
@@ -44,7 +62,19 @@ std::vector<float> recall(const Eigen::MatrixXi &confusionMatrix);
 */
 std::vector<float> f1Score(const Eigen::MatrixXi &confusionMatrix);
 
+/*
+  The Wilson score interval of the accuracy for the given confusion matrix,
+  where z is the standard score of the confidence level.
+*/
+std::pair<float, float> accuracyInterval(const Eigen::MatrixXi &confusionMatrix,
+                                         double z = 1.96);
+
 const std::unordered_set<std::string> SINGLE_VALUE_METRICS{"accuracy", "loss"};
+/*
+  The metrics that improve as they decrease.
+*/
+const std::unordered_set<std::string> LOWER_IS_BETTER_METRICS{
+    "loss", "calibration_error"};
 const std::unordered_map<
     std::string,
     std::function<std::variant<float, std::vector<float>>(Eigen::MatrixXi)>>
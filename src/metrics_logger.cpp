@@ -0,0 +1,166 @@
+#include "metrics_logger.hpp"
+#include "exceptions/metrics_logger.hpp"
+#include "streaming_metrics.hpp"
+#include <chrono>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+using namespace metrics_logger;
+
+#pragma region Record
+double Record::getSamplesPerSecond() const {
+  return this->seconds > 0 ? this->samples / this->seconds : 0;
+}
+
+json Record::toJson(const std::vector<std::string> &classes) const {
+  json metrics = json::object();
+  for (const auto &[metric, value] : this->metrics) {
+    if (std::holds_alternative<float>(value)) {
+      metrics[metric] = std::get<float>(value);
+      continue;
+    }
+    const std::vector<float> &values = std::get<std::vector<float>>(value);
+    if (metrics::isStreamingMetric(metric)) {
+      // Binned metrics, such as the confidence histogram
+      metrics[metric] = values;
+      continue;
+    }
+    json perClass = json::object();
+    for (int i = 0; i < values.size(); ++i) {
+      perClass[classes[i]] = values[i];
+    }
+    metrics[metric] = perClass;
+  }
+
+  std::chrono::duration<double> timestamp =
+      std::chrono::system_clock::now().time_since_epoch();
+  json values{{"timestamp", timestamp.count()},
+              {"split", this->split},
+              {"epoch", this->epoch},
+              {"batch", this->batch},
+              {"batches", this->batches},
+              {"samples", this->samples},
+              {"seconds", this->seconds},
+              {"samples_per_second", this->getSamplesPerSecond()},
+              {"metrics", metrics}};
+  if (!this->timings.empty()) {
+    json timings = json::object();
+    for (const utils::timer::Timing &timing : this->timings) {
+      timings[timing.stage] = timing.seconds;
+    }
+    values["timings"] = timings;
+  }
+  return values;
+}
+#pragma endregion Record
+
+#pragma region Metrics logger
+MetricsLogger::MetricsLogger(std::filesystem::path path,
+                             std::vector<std::string> classes)
+    : path(path), classes(classes) {
+  if (path.extension() == ".jsonl") {
+    this->format = Format::JSONL;
+  } else if (path.extension() == ".prom") {
+    this->format = Format::PROMETHEUS;
+  } else {
+    throw exceptions::metrics_logger::InvalidExtensionException(
+        path.extension());
+  }
+
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path());
+  }
+}
+
+Format MetricsLogger::getFormat() const { return this->format; }
+
+void MetricsLogger::log(const Record &record) {
+  if (this->format == Format::JSONL) {
+    this->appendJson(record);
+  } else {
+    this->latest[record.split] = record;
+    this->writePrometheus();
+  }
+}
+
+void MetricsLogger::appendJson(const Record &record) const {
+  std::ofstream file(this->path, std::ios::app);
+  file << record.toJson(this->classes).dump() << std::endl;
+}
+
+/*
+  Escape the label value for the Prometheus text format.
+*/
+static std::string escapeLabel(const std::string &value) {
+  std::string result;
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      result += '\\';
+      result += c;
+    } else if (c == '\n') {
+      result += "\\n";
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+void MetricsLogger::writePrometheus() const {
+  // Group the samples by metric name, as each name may only appear once
+  std::map<std::string, std::vector<std::string>> families;
+  auto add = [&](const std::string &name, const std::string &labels,
+                 double value) {
+    std::ostringstream sample;
+    sample.precision(10);
+    sample << "nn_" << name << "{" << labels << "} " << value;
+    families[name].push_back(sample.str());
+  };
+
+  for (const auto &[split, record] : this->latest) {
+    std::string labels = "split=\"" + escapeLabel(split) + "\"";
+    add("epoch", labels, record.epoch);
+    add("batch", labels, record.batch);
+    add("batches", labels, record.batches);
+    add("samples", labels, record.samples);
+    add("seconds", labels, record.seconds);
+    add("samples_per_second", labels, record.getSamplesPerSecond());
+
+    for (const auto &[metric, value] : record.metrics) {
+      if (std::holds_alternative<float>(value)) {
+        add(metric, labels, std::get<float>(value));
+        continue;
+      }
+      const std::vector<float> &values = std::get<std::vector<float>>(value);
+      bool isBinned = metrics::isStreamingMetric(metric);
+      for (int i = 0; i < values.size(); ++i) {
+        std::string label = isBinned
+                                ? ",bin=\"" + std::to_string(i)
+                                : ",class=\"" + escapeLabel(this->classes[i]);
+        add(metric, labels + label + "\"", values[i]);
+      }
+    }
+
+    for (const utils::timer::Timing &timing : record.timings) {
+      add("stage_seconds",
+          labels + ",stage=\"" + escapeLabel(timing.stage) + "\"",
+          timing.seconds);
+    }
+  }
+
+  // Replace the file only once complete so readers never see a partial file
+  std::filesystem::path tempPath = this->path;
+  tempPath += ".tmp";
+  {
+    std::ofstream file(tempPath);
+    for (const auto &[name, samples] : families) {
+      file << "# TYPE nn_" << name << " gauge\n";
+      for (const std::string &sample : samples) {
+        file << sample << "\n";
+      }
+    }
+  }
+  std::filesystem::rename(tempPath, this->path);
+}
+#pragma endregion Metrics logger
@@ -0,0 +1,99 @@
+#pragma once
+#include "utils/timer.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace metrics_logger {
+#pragma region Record
+/*
+  A snapshot of the metrics of a split, taken either partway through or at the
+  end of an epoch.
+*/
+struct Record {
+  std::string split;
+  int epoch = 0, batch = 0, batches = 0;
+  std::size_t samples = 0;
+  double seconds = 0;
+  std::unordered_map<std::string, std::variant<float, std::vector<float>>>
+      metrics;
+  std::vector<utils::timer::Timing> timings = {};
+
+  /*
+    Get the samples processed per second.
+  */
+  double getSamplesPerSecond() const;
+
+  /*
+    Get all the relevant attributes in a serialisable format, with the
+    per-class metrics keyed by the given classes and the binned streaming
+    metrics as arrays.
+
+    Attributes:
+            - timestamp -- the Unix time in seconds the record was written at
+            - split -- the split the metrics are for, train or validation
+            - epoch -- the epoch, starting at 1
+            - batch -- the number of minibatches processed in the epoch
+            - batches -- the number of minibatches in the epoch
+            - samples -- the number of samples processed in the epoch
+            - seconds -- the time spent processing the samples
+            - samples_per_second -- the throughput
+            - metrics -- the value of each tracked metric
+            - timings -- the total seconds spent in each stage, if timed
+  */
+  json toJson(const std::vector<std::string> &classes) const;
+};
+#pragma endregion Record
+
+#pragma region Metrics logger
+/*
+  The file formats the metrics can be written in.
+*/
+enum class Format { JSONL, PROMETHEUS };
+
+/*
+  Writes the training metrics to a file for external monitoring.
+
+  JSONL files (.jsonl) have one record appended per line. Prometheus files
+  (.prom) are in the text exposition format and are replaced with the latest
+  record of each split on every write, such as for node exporter's textfile
+  collector.
+*/
+class MetricsLogger {
+  std::filesystem::path path;
+  Format format;
+  std::vector<std::string> classes;
+  std::map<std::string, Record> latest;
+
+  /*
+    Append the record as a line of JSON.
+  */
+  void appendJson(const Record &record) const;
+
+  /*
+    Replace the file with the latest records in the Prometheus text format.
+  */
+  void writePrometheus() const;
+
+public:
+  MetricsLogger(std::filesystem::path path, std::vector<std::string> classes);
+
+  /*
+    Get the format of the file.
+  */
+  Format getFormat() const;
+
+  /*
+    Write the record.
+  */
+  void log(const Record &record);
+};
+#pragma endregion Metrics logger
+} // namespace metrics_logger
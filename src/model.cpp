@@ -1,20 +1,33 @@
 #include "model.hpp"
+#include "activation_functions.hpp"
+#include "checkpoint.hpp"
+#include "early_stopping.hpp"
+#include "exceptions/early_stopping.hpp"
 #include "exceptions/load.hpp"
 #include "exceptions/model.hpp"
 #include "image_loader.hpp"
 #include "linear.hpp"
+#include "lr_scheduler.hpp"
 #include "metrics.hpp"
+#include "metrics_logger.hpp"
+#include "model_parser.hpp"
+#include "streaming_metrics.hpp"
+#include "utils/allocations.hpp"
 #include "utils/cli.hpp"
 #include "utils/indicator.hpp"
 #include "utils/math.hpp"
+#include "utils/memory.hpp"
 #include "utils/string.hpp"
+#include "utils/timer.hpp"
+#include "utils/trace.hpp"
 #include <Eigen/Dense>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
+#include <fstream>
 #include <functional>
-#include <indicators/cursor_control.hpp>
-#include <indicators/progress_bar.hpp>
-#include <indicators/setting.hpp>
 #include <initializer_list>
 #include <iostream>
 #include <map>
@@ -24,13 +37,47 @@
 #include <matplot/util/common.h>
 #include <matplot/util/handle_types.h>
 #include <matplot/util/keywords.h>
+#include <memory>
+#include <mutex>
 #include <nlohmann/json.hpp>
+#include <set>
+#include <span>
+#include <string>
 #include <tabulate/table.hpp>
+#include <thread>
+#include <tuple>
 #include <typeinfo>
 #include <unordered_set>
+#include <variant>
 
 using namespace model;
 
+#pragma region Architecture
+std::vector<linear::Linear>
+model::buildLayers(int inputs, const std::vector<LayerConfig> &layers,
+                   int outputs) {
+  if (layers.empty()) {
+    throw exceptions::model::EmptyLayersVectorException();
+  }
+  for (const LayerConfig &layer : layers) {
+    if (layer.size < 1) {
+      throw exceptions::model::InvalidLayerSizeException(layer.size);
+    }
+  }
+  if (layers.back().size != outputs) {
+    throw exceptions::model::MismatchedOutputSizeException(layers.back().size,
+                                                           outputs);
+  }
+
+  std::vector<linear::Linear> result;
+  for (const LayerConfig &layer : layers) {
+    result.push_back(linear::Linear(inputs, layer.size, layer.activation));
+    inputs = layer.size;
+  }
+  return result;
+}
+#pragma endregion Architecture
+
 #pragma region Keyword args
 void Model::KeywordArgs::setTrainMetricsFromMetricTypes(
     std::vector<std::string> metrics) {
@@ -113,7 +160,7 @@ void Model::setTotalEpochs(int totalEpochs) {
 #pragma endregion Total epochs
 
 #pragma region Train metrics
-std::unordered_map<std::string, metricHistoryValue>
+const std::unordered_map<std::string, metricHistoryValue> &
 Model::getTrainMetrics() const {
   return this->trainMetrics;
 }
@@ -130,7 +177,7 @@ void Model::setTrainMetrics(std::vector<std::string> metrics) {
 #pragma endregion Train metrics
 
 #pragma region Validation metrics
-std::unordered_map<std::string, metricHistoryValue>
+const std::unordered_map<std::string, metricHistoryValue> &
 Model::getValidationMetrics() const {
   return this->validationMetrics;
 }
@@ -145,6 +192,34 @@ void Model::setValidationMetrics(std::vector<std::string> metrics) {
   this->setValidationMetrics(Model::metricTypesToHistory(metrics));
 }
 #pragma endregion Validation metrics
+
+#pragma region Memory
+std::size_t Model::getParameterSize() const {
+  std::size_t size = 0;
+  for (const linear::Linear &layer : this->layers) {
+    size += layer.getParameterSize();
+  }
+  return size;
+}
+
+std::size_t Model::getCacheSize() const {
+  std::size_t size = this->loss.getCacheSize();
+  for (const linear::Linear &layer : this->layers) {
+    size += layer.getCacheSize();
+  }
+  return size;
+}
+
+std::size_t Model::getMetricHistorySize() const {
+  std::size_t size = 0;
+  for (const auto *metrics : {&this->trainMetrics, &this->validationMetrics}) {
+    for (const auto &[metric, history] : *metrics) {
+      size += history.getSize();
+    }
+  }
+  return size;
+}
+#pragma endregion Memory
 #pragma endregion Properties
 
 #pragma region Load
@@ -157,6 +232,13 @@ Model Model::fromJson(const json &values) {
   for (const json &layerData : values["layers"]) {
     layers.push_back(linear::Linear::fromJson(layerData));
   }
+  return Model::fromJson(values, std::move(layers));
+}
+
+Model Model::fromJson(const json &values, std::vector<linear::Linear> layers) {
+  if (values["class"] != "Model") {
+    throw exceptions::load::InvalidClassAttributeValue();
+  }
 
   loss::CrossEntropyLoss loss =
       loss::CrossEntropyLoss::fromJson(values["loss"]);
@@ -167,8 +249,9 @@ Model Model::fromJson(const json &values) {
   auto jsonToMetricsHistory = [](const json &data) {
     std::unordered_map<std::string, metricHistoryValue> result;
     for (const auto &[metric, history] : data.items()) {
-      metricHistoryValue row;
-      if (metrics::SINGLE_VALUE_METRICS.contains(metric)) {
+      metricHistoryValue &row = result[metric];
+      row.reserve(history.size());
+      if (metrics::isSingleValueMetric(metric)) {
         for (const auto &x : history) {
           row.push_back((float)x);
         }
@@ -177,14 +260,13 @@ Model Model::fromJson(const json &values) {
           row.push_back((std::vector<float>)(x));
         }
       }
-      result[metric] = row;
     }
     return result;
   };
   kwargs.trainMetrics = jsonToMetricsHistory(values["train_metrics"]);
   kwargs.validationMetrics = jsonToMetricsHistory(values["validation_metrics"]);
 
-  return Model(layers, loss, kwargs);
+  return Model(std::move(layers), loss, kwargs);
 }
 
 Model Model::load(std::string path) {
@@ -193,33 +275,14 @@ Model Model::load(std::string path) {
     throw exceptions::model::InvalidExtensionException(filePath.extension());
   }
 
-  json values;
-  std::ifstream(filePath) >> values;
-  return Model::fromJson(values);
+  std::ifstream file(filePath);
+  auto [values, layers] = parser::parse(file);
+  return Model::fromJson(values, std::move(layers));
 }
 #pragma endregion Load
 
 #pragma region Save
 json Model::toJson() const {
-  auto metricsHistoryToJson =
-      [](const std::unordered_map<std::string, metricHistoryValue> &metrics) {
-        json result;
-        for (const auto &[metric, history] : metrics) {
-          json data = json::array();
-          if (metrics::SINGLE_VALUE_METRICS.contains(metric)) {
-            for (const auto &x : history) {
-              data.push_back(std::get<float>(x));
-            }
-          } else {
-            for (const auto &x : history) {
-              data.push_back(std::get<std::vector<float>>(x));
-            }
-          }
-          result[metric] = data;
-        }
-        return result;
-      };
-
   json layers = json::array();
   for (const linear::Linear &layer : this->layers) {
     layers.push_back(layer.toJson());
@@ -229,8 +292,9 @@ json Model::toJson() const {
           {"layers", layers},
           {"loss", this->loss.toJson()},
           {"total_epochs", this->totalEpochs},
-          {"train_metrics", metricsHistoryToJson(this->trainMetrics)},
-          {"validation_metrics", metricsHistoryToJson(this->validationMetrics)},
+          {"train_metrics", Model::metricsHistoryToJson(this->trainMetrics)},
+          {"validation_metrics",
+           Model::metricsHistoryToJson(this->validationMetrics)},
           {"classes", this->classes}};
 }
 
@@ -244,13 +308,44 @@ void Model::save(const std::string &path) const {
   file << this->toJson().dump();
   file.close();
 }
+
+void Model::copyTo(Model &snapshot) const {
+  if (snapshot.layers.size() == this->layers.size()) {
+    for (int i = 0; i < this->layers.size(); ++i) {
+      this->layers[i].copyParametersTo(snapshot.layers[i]);
+    }
+  } else {
+    snapshot.layers.clear();
+    for (const linear::Linear &layer : this->layers) {
+      snapshot.layers.emplace_back(layer.getWeight(), layer.getBias(),
+                                   layer.getActivation()->getName());
+      snapshot.layers.back().setEval(true);
+    }
+  }
+  snapshot.eval = true;
+  snapshot.loss = loss::CrossEntropyLoss(this->loss.getReduction());
+  snapshot.totalEpochs = this->totalEpochs;
+  snapshot.trainMetrics = this->trainMetrics;
+  snapshot.validationMetrics = this->validationMetrics;
+  snapshot.classes = this->classes;
+}
 #pragma endregion Save
 
 #pragma region Forward pass
 Eigen::MatrixXd Model::forward(const Eigen::MatrixXd &input) {
   Eigen::MatrixXd out = input;
-  for (linear::Linear &layer : this->layers) {
-    out = layer(out);
+  for (int i = 0; i < this->layers.size(); ++i) {
+    utils::trace::ScopedEvent event("Forward layer", "forward", i + 1);
+    out = this->layers[i](out);
+  }
+  return out;
+}
+
+Eigen::MatrixXd Model::infer(const Eigen::MatrixXd &input) const {
+  Eigen::MatrixXd out = input;
+  for (int i = 0; i < this->layers.size(); ++i) {
+    utils::trace::ScopedEvent event("Forward layer", "forward", i + 1);
+    out = this->layers[i].infer(out);
   }
   return out;
 }
@@ -270,82 +365,398 @@ std::vector<std::string> Model::predict(const Eigen::MatrixXd &input) {
 #pragma endregion Forward pass
 
 #pragma region Train
-float Model::getLossWithConfusionMatrix(const Eigen::MatrixXd &input,
-                                        Eigen::MatrixXi &confusionMatrix,
-                                        const std::vector<int> &labels) {
-  Eigen::MatrixXd logits = this->forward(input);
-  metrics::addToConfusionMatrix(
-      confusionMatrix, utils::math::logitsToPrediction(logits), labels);
-  return this->loss(logits, labels);
+float Model::getLossWithConfusionMatrix(
+    const Eigen::MatrixXd &input, Eigen::MatrixXi &confusionMatrix,
+    const std::vector<int> &labels,
+    metrics::StreamingMetrics *streaming) const {
+  Eigen::MatrixXd logits = this->infer(input);
+  {
+    utils::trace::ScopedEvent event("Metrics", "metrics");
+    metrics::addToConfusionMatrix(confusionMatrix, logits, labels);
+    if (streaming != nullptr) {
+      streaming->update(logits, labels);
+    }
+  }
+  utils::trace::ScopedEvent event("Loss", "loss");
+  return this->loss.evaluate(logits, labels);
 }
 
 float Model::trainStep(const Eigen::MatrixXd &data,
                        const std::vector<int> &labels, double learningRate,
-                       Eigen::MatrixXi &confusionMatrix) {
-  float loss = this->getLossWithConfusionMatrix(data, confusionMatrix, labels);
-  Eigen::MatrixXd grad = this->loss.backward();
-  for (auto it = this->layers.rbegin(); it != this->layers.rend(); ++it) {
-    grad = it->update(grad, learningRate);
+                       Eigen::MatrixXi &confusionMatrix,
+                       utils::timer::StageTimer *timer,
+                       utils::memory::MemoryTracker *memory,
+                       metrics::StreamingMetrics *streaming) {
+  using utils::timer::ScopedTimer;
+
+  Eigen::MatrixXd logits = data;
+  for (int i = 0; i < this->layers.size(); ++i) {
+    ScopedTimer scope(timer, "Forward layer", "forward", i + 1);
+    logits = this->layers[i](logits);
+  }
+
+  {
+    ScopedTimer scope(timer, "Metrics", "metrics");
+    metrics::addToConfusionMatrix(confusionMatrix, logits, labels);
+    if (streaming != nullptr) {
+      streaming->update(logits, labels);
+    }
+  }
+
+  float loss;
+  Eigen::MatrixXd grad;
+  {
+    ScopedTimer scope(timer, "Loss", "loss");
+    loss = this->loss(logits, labels);
+    grad = this->loss.backward();
+  }
+
+  std::size_t gradientSize = 0;
+  for (int i = this->layers.size() - 1; i >= 0; --i) {
+    linear::Linear &layer = this->layers[i];
+    Eigen::MatrixXd weightGrad, biasGrad;
+    {
+      ScopedTimer scope(timer, "Backward layer", "backward", i + 1);
+      std::tie(grad, weightGrad, biasGrad) = layer.backward(grad);
+    }
+    gradientSize = std::max(gradientSize,
+                            utils::memory::getSize(grad) +
+                                utils::memory::getSize(weightGrad) +
+                                utils::memory::getSize(biasGrad));
+    ScopedTimer scope(timer, "Update layer", "update", i + 1);
+    layer.applyGradients(weightGrad, biasGrad, learningRate);
+  }
+  if (memory != nullptr) {
+    memory->record("Gradients", gradientSize);
   }
   return loss;
 }
 
 void Model::train(const loader::ImageLoader &loader, double learningRate,
-                  int batchSize, int epochs) {
+                  int batchSize, int epochs, const TrainKeywordArgs &kwargs) {
   this->classes = loader.getClasses();
-  for (int epoch = 1; epoch < epochs + 1; ++epoch) {
+
+  std::unique_ptr<checkpoint::Checkpointer> checkpointer;
+  if (!kwargs.checkpointPath.empty()) {
+    checkpointer =
+        std::make_unique<checkpoint::Checkpointer>(kwargs.checkpointPath);
+  }
+  auto lastCheckpoint = std::chrono::steady_clock::now();
+  auto isCheckpointTimeElapsed = [&]() {
+    std::chrono::duration<double, std::ratio<60>> elapsed =
+        std::chrono::steady_clock::now() - lastCheckpoint;
+    return checkpointer != nullptr && kwargs.checkpointMinutes > 0 &&
+           elapsed.count() >= kwargs.checkpointMinutes;
+  };
+  auto saveCheckpoint = [&](checkpoint::State state) {
+    state.epochs = epochs;
+    state.learningRate = learningRate;
+    state.seed = kwargs.start.seed;
+    utils::trace::ScopedEvent event("Snapshot checkpoint", "checkpoint");
+    checkpointer->save(*this, state);
+    lastCheckpoint = std::chrono::steady_clock::now();
+  };
+
+  std::unique_ptr<utils::timer::StageTimer> ownedTimer;
+  utils::timer::StageTimer *timer = nullptr;
+  if (kwargs.timings) {
+    if (kwargs.timer == nullptr) {
+      ownedTimer = std::make_unique<utils::timer::StageTimer>();
+    }
+    timer = kwargs.timer != nullptr ? kwargs.timer : ownedTimer.get();
+  }
+  std::unique_ptr<utils::memory::MemoryTracker> memory;
+  if (kwargs.memoryUsage) {
+    memory = std::make_unique<utils::memory::MemoryTracker>();
+  }
+  std::unique_ptr<utils::allocations::AllocationTracker> allocations;
+  if (kwargs.allocationCounts) {
+    allocations = std::make_unique<utils::allocations::AllocationTracker>();
+  }
+  std::unique_ptr<metrics_logger::MetricsLogger> logger;
+  if (!kwargs.metricsLogPath.empty()) {
+    logger = std::make_unique<metrics_logger::MetricsLogger>(
+        kwargs.metricsLogPath, this->classes);
+  }
+  auto logMetrics = [&](metrics_logger::Record record,
+                        std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    record.seconds = elapsed.count();
+    if (timer != nullptr && record.split == "train") {
+      record.timings = timer->getTimings();
+    }
+    logger->log(record);
+  };
+
+  // The streaming metrics of a partial epoch are not checkpointed, so those of
+  // a resumed epoch only cover the minibatches trained after resuming
+  auto getStreamingMetrics =
+      [](const std::unordered_map<std::string, metricHistoryValue> &metrics) {
+        std::vector<std::string> types;
+        for (const auto &[metric, _] : metrics) {
+          types.push_back(metric);
+        }
+        return metrics::StreamingMetrics(types);
+      };
+  metrics::StreamingMetrics trainStreaming =
+      getStreamingMetrics(this->trainMetrics);
+  metrics::StreamingMetrics validationStreaming =
+      getStreamingMetrics(this->validationMetrics);
+
+  std::unique_ptr<early_stopping::EarlyStopping> earlyStopping;
+  std::vector<std::pair<Eigen::MatrixXd, Eigen::VectorXd>> bestWeights;
+  if (kwargs.earlyStoppingPatience > 0) {
+    earlyStopping = std::make_unique<early_stopping::EarlyStopping>(
+        kwargs.earlyStoppingMetric, kwargs.earlyStoppingPatience,
+        kwargs.earlyStoppingMinDelta);
+    if (!this->validationMetrics.contains(kwargs.earlyStoppingMetric)) {
+      throw exceptions::early_stopping::UntrackedMetricException(
+          kwargs.earlyStoppingMetric);
+    }
+  }
+
+  loader::DatasetBatcher::KeywordArgs trainingKwargs;
+  trainingKwargs.seed = kwargs.start.seed;
+  for (int epoch = kwargs.start.epoch; epoch < epochs + 1; ++epoch) {
+    bool isResumed = epoch == kwargs.start.epoch && kwargs.start.batch > 0;
+
     // Training
     {
       std::shared_ptr<loader::DatasetBatcher> trainingData =
-          loader("train", batchSize);
+          loader("train", batchSize, trainingKwargs);
+      lr_scheduler::Scheduler scheduler(learningRate, epochs,
+                                        trainingData->size(),
+                                        kwargs.learningRateSchedule);
       Eigen::MatrixXi confusionMatrix =
-          metrics::getNewConfusionMatrix(this->classes.size());
-      float loss = 0;
-
-      indicators::show_console_cursor(false);
-      int count = 0;
-      ProgressBar bar = utils::indicators::getDefaultProgressBar();
-      bar.set_option(indicators::option::PrefixText{
+          isResumed ? kwargs.start.confusionMatrix
+                    : metrics::getNewConfusionMatrix(this->classes.size());
+      float loss = isResumed ? kwargs.start.loss : 0;
+      int startBatch = isResumed ? kwargs.start.batch : 0;
+      auto start = std::chrono::steady_clock::now();
+      std::size_t samples = 0;
+
+      utils::indicators::ProgressReporter progress(
           "Training epoch " + std::to_string(epoch) + "/" +
-          std::to_string(epochs) + ": "});
-      bar.set_option(indicators::option::MaxProgress{trainingData->size()});
-
-      for (const auto &[data, labels] : *trainingData) {
-        loss += this->trainStep(data, labels, learningRate, confusionMatrix);
-        bar.set_option(
-            option::PostfixText{std::to_string(++count) + "/" +
-                                std::to_string(trainingData->size())});
-        bar.tick();
+              std::to_string(epochs) + ": ",
+          trainingData->size(), startBatch, kwargs.verbose);
+      if (timer != nullptr) {
+        timer->clear();
+      }
+      if (memory != nullptr) {
+        memory->clear();
+      }
+      if (allocations != nullptr) {
+        allocations->clear();
+      }
+      trainStreaming.reset();
+
+      for (int batch = startBatch; batch < trainingData->size(); ++batch) {
+        loader::minibatch minibatch;
+        {
+          utils::timer::ScopedTimer scope(timer, "Load batch",
+                                          "loader");
+          utils::allocations::ScopedCounter counter;
+          minibatch = (*trainingData)[batch];
+          if (allocations != nullptr) {
+            allocations->record("Load batch", counter.get());
+          }
+        }
+        const auto &[data, labels] = minibatch;
+        {
+          utils::allocations::ScopedCounter counter;
+          double batchLearningRate =
+              scheduler((epoch - 1) * trainingData->size() + batch);
+          loss += this->trainStep(data, labels, batchLearningRate,
+                                  confusionMatrix, timer, memory.get(),
+                                  &trainStreaming);
+          if (allocations != nullptr) {
+            allocations->record("Train step", counter.get());
+          }
+        }
+        if (memory != nullptr) {
+          memory->record("Weights", this->getParameterSize());
+          memory->record("Activations", this->getCacheSize());
+          memory->record("Loaded batch",
+                         utils::memory::getSize(data) +
+                             labels.size() * sizeof(int));
+        }
+        samples += labels.size();
+        progress.tick();
+
+        if (logger != nullptr && kwargs.metricsLogBatches > 0 &&
+            (batch + 1) % kwargs.metricsLogBatches == 0 &&
+            batch + 1 < trainingData->size()) {
+          metrics_logger::Record record{
+              .split = "train",
+              .epoch = epoch,
+              .batch = batch + 1,
+              .batches = trainingData->size(),
+              .samples = samples,
+              .metrics = Model::calculateMetrics(
+                  this->trainMetrics, confusionMatrix, loss / (batch + 1),
+                  &trainStreaming)};
+          logMetrics(record, start);
+        }
+
+        if (isCheckpointTimeElapsed()) {
+          checkpoint::State state;
+          state.epoch = epoch;
+          state.batch = batch + 1;
+          state.loss = loss;
+          state.confusionMatrix = confusionMatrix;
+          saveCheckpoint(state);
+        }
+      }
+      progress.finish();
+      if (kwargs.verbose && !scheduler.isConstant()) {
+        std::cout << "Learning rate: "
+                  << scheduler(epoch * trainingData->size() - 1) << std::endl;
       }
       loss /= trainingData->size();
-      Model::storeMetrics(this->trainMetrics, confusionMatrix, loss);
-      Model::printMetrics(this->trainMetrics, this->classes);
-      indicators::show_console_cursor(true);
+      Model::storeMetrics(this->trainMetrics, confusionMatrix, loss,
+                          &trainStreaming);
+      if (kwargs.verbose) {
+        Model::printMetrics(this->trainMetrics, this->classes);
+      }
+      if (logger != nullptr) {
+        metrics_logger::Record record{
+            .split = "train",
+            .epoch = epoch,
+            .batch = trainingData->size(),
+            .batches = trainingData->size(),
+            .samples = samples,
+            .metrics = Model::calculateMetrics(
+                this->trainMetrics, confusionMatrix, loss, &trainStreaming)};
+        logMetrics(record, start);
+      }
+      if (kwargs.verbose && timer != nullptr) {
+        utils::timer::printTimings(*timer);
+      }
+      if (memory != nullptr) {
+        memory->record("Metric history", this->getMetricHistorySize());
+        if (kwargs.verbose) {
+          utils::memory::printMemory(*memory);
+        }
+      }
     }
 
     // Validation
     {
+      // Validate on a fixed stratified sample between the full passes
+      bool isSampled =
+          kwargs.validationSamples > 0 && epoch != epochs &&
+          (kwargs.fullValidationEpochs <= 0 ||
+           epoch % kwargs.fullValidationEpochs != 0);
+      loader::DatasetBatcher::KeywordArgs validationKwargs;
+      validationKwargs.shuffle = false;
+      validationKwargs.samples = isSampled ? kwargs.validationSamples : 0;
       std::shared_ptr<loader::DatasetBatcher> validationData =
-          loader("test", batchSize);
-      if (validationData->size() == 0) {
-        continue;
-      }
+          isSampled ? loader("test", batchSize, validationKwargs)
+                    : loader("test", batchSize);
+      if (validationData->size() > 0) {
+        auto start = std::chrono::steady_clock::now();
+        validationStreaming.reset();
+        auto [loss, confusionMatrix] = this->test(
+            validationData,
+            "Validation epoch " + std::to_string(epoch) + "/" +
+                std::to_string(epochs) + ": ",
+            TestKeywordArgs{kwargs.testWorkers, allocations.get(),
+                            &validationStreaming, kwargs.verbose});
+        Model::storeMetrics(this->validationMetrics, confusionMatrix, loss,
+                            &validationStreaming);
+        if (kwargs.verbose) {
+          Model::printMetrics(this->validationMetrics, this->classes);
+        }
+        if (kwargs.verbose && isSampled) {
+          auto [lower, upper] = metrics::accuracyInterval(confusionMatrix);
+          std::cout << "Sampled validation over " << confusionMatrix.sum()
+                    << " samples, accuracy 95% CI: ["
+                    << utils::string::floatToString(lower, 4) << ", "
+                    << utils::string::floatToString(upper, 4) << "]"
+                    << std::endl;
+        }
+        if (logger != nullptr) {
+          metrics_logger::Record record{
+              .split = "validation",
+              .epoch = epoch,
+              .batch = validationData->size(),
+              .batches = validationData->size(),
+              .samples = (std::size_t)confusionMatrix.sum(),
+              .metrics = Model::calculateMetrics(this->validationMetrics,
+                                                 confusionMatrix, loss,
+                                                 &validationStreaming)};
+          logMetrics(record, start);
+        }
 
-      auto [loss, confusionMatrix] = this->test(
-          validationData, "Validation epoch " + std::to_string(epoch) + "/" +
-                              std::to_string(epochs) + ": ");
-      Model::storeMetrics(this->validationMetrics, confusionMatrix, loss);
-      Model::printMetrics(this->validationMetrics, this->classes);
+        // Only the full passes are compared, as the sampled estimate is a
+        // different measurement, so training only stops after a full pass
+        if (earlyStopping != nullptr && !isSampled) {
+          float value =
+              this->validationMetrics.at(earlyStopping->getMetric()).back()[0];
+          // Snapshot the weights in memory rather than serialising the model
+          if (earlyStopping->update(value, epoch) &&
+              kwargs.restoreBestWeights) {
+            bestWeights.clear();
+            for (const linear::Linear &layer : this->layers) {
+              bestWeights.emplace_back(layer.getWeight(), layer.getBias());
+            }
+          }
+        }
+      }
+    }
+    bool isStopping = earlyStopping != nullptr && earlyStopping->shouldStop();
+    if (kwargs.verbose && isStopping) {
+      std::cout << "Early stopping after epoch " << epoch << ", "
+                << earlyStopping->getMetric()
+                << " has not improved since epoch "
+                << earlyStopping->getBestEpoch() << "." << std::endl;
+    }
+    // Training ends with the best weights, whether or not it stopped early
+    if ((isStopping || epoch == epochs) && !bestWeights.empty() &&
+        earlyStopping->getBestEpoch() != epoch) {
+      for (int i = 0; i < this->layers.size(); ++i) {
+        this->layers[i].setWeight(bestWeights[i].first);
+        this->layers[i].setBias(bestWeights[i].second);
+      }
+      if (kwargs.verbose) {
+        std::cout << "Restored the weights of epoch "
+                  << earlyStopping->getBestEpoch() << "." << std::endl;
+      }
+    }
+    if (kwargs.verbose && allocations != nullptr) {
+      utils::allocations::printAllocations(*allocations);
+    }
+    ++this->totalEpochs;
+
+    // Checkpoint
+    if (checkpointer != nullptr &&
+        (epoch == epochs || isStopping ||
+         (kwargs.checkpointEpochs > 0 &&
+          epoch % kwargs.checkpointEpochs == 0) ||
+         isCheckpointTimeElapsed())) {
+      // A stopped run is complete, so resuming it trains no further epochs
+      checkpoint::State state;
+      state.epoch = isStopping ? epochs + 1 : epoch + 1;
+      saveCheckpoint(state);
+    }
+    if (isStopping) {
+      break;
     }
   }
-  this->totalEpochs += epochs;
+}
+
+void Model::train(const loader::ImageLoader &loader, double learningRate,
+                  int batchSize, int epochs) {
+  this->train(loader, learningRate, batchSize, epochs, TrainKeywordArgs());
 }
 #pragma endregion Train
 
 #pragma region Test
 std::pair<float, Eigen::MatrixXi>
 Model::test(const std::shared_ptr<loader::DatasetBatcher> batcher,
-            const std::string &indicatorDescription) {
+            const std::string &indicatorDescription,
+            const TestKeywordArgs &kwargs) {
   if (this->classes.empty()) {
     throw exceptions::model::MissingClassesException();
   }
@@ -353,36 +764,92 @@ Model::test(const std::shared_ptr<loader::DatasetBatcher> batcher,
   bool evalMode = this->eval;
   this->setEval(true);
 
-  // Set up indicator
-  int count = 0;
-  indicators::show_console_cursor(false);
-  indicators::ProgressBar bar = utils::indicators::getDefaultProgressBar();
-  bar.set_option(indicators::option::PrefixText{indicatorDescription});
-  bar.set_option(indicators::option::MaxProgress{batcher->size()});
+  int size = batcher->size(),
+      workers = std::clamp(kwargs.workers, 1, std::max(size, 1));
+  utils::indicators::ProgressReporter progress(indicatorDescription, size, 0,
+                                               kwargs.verbose);
+
+  // Perform the inference pass, with each worker taking the next batch
+  std::vector<float> losses(size);
+  std::vector<Eigen::MatrixXi> confusionMatrices(
+      workers, metrics::getNewConfusionMatrix(this->classes.size()));
+  std::vector<metrics::StreamingMetrics> streaming;
+  if (kwargs.streaming != nullptr) {
+    streaming = std::vector<metrics::StreamingMetrics>(workers,
+                                                       *kwargs.streaming);
+    for (metrics::StreamingMetrics &accumulators : streaming) {
+      accumulators.reset();
+    }
+  }
+  std::atomic<int> next = 0;
+  std::mutex mutex;
+  std::exception_ptr error;
+  auto work = [&](int worker) {
+    if (worker > 0 && utils::trace::isEnabled()) {
+      utils::trace::setThreadName("Test worker " + std::to_string(worker));
+    }
+    try {
+      for (int batch; (batch = next.fetch_add(1)) < size;) {
+        const auto [data, labels] = (*batcher)[batch];
+        utils::allocations::ScopedCounter counter;
+        losses[batch] = this->getLossWithConfusionMatrix(
+            data, confusionMatrices[worker], labels,
+            streaming.empty() ? nullptr : &streaming[worker]);
+        if (kwargs.allocations != nullptr) {
+          std::lock_guard<std::mutex> lock(mutex);
+          kwargs.allocations->record("Test step", counter.get());
+        }
+        progress.tick();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+      next = size;
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int worker = 1; worker < workers; ++worker) {
+    threads.emplace_back(work, worker);
+  }
+  work(0);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  progress.finish();
+  this->setEval(evalMode);
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
 
-  // Perform forward and backward pass
-  Eigen::MatrixXi confusionMatrix =
-      metrics::getNewConfusionMatrix(this->classes.size());
+  // Reduce in batch order to match a single worker
   float loss = 0;
-  for (const auto &[data, labels] : *batcher) {
-    loss += this->getLossWithConfusionMatrix(data, confusionMatrix, labels);
-    bar.set_option(option::PostfixText{std::to_string(++count) + "/" +
-                                       std::to_string(batcher->size())});
-    bar.tick();
+  for (float batchLoss : losses) {
+    loss += batchLoss;
+  }
+  loss /= size;
+  Eigen::MatrixXi confusionMatrix = confusionMatrices[0];
+  for (int worker = 1; worker < workers; ++worker) {
+    metrics::mergeConfusionMatrix(confusionMatrix, confusionMatrices[worker]);
+  }
+  for (const metrics::StreamingMetrics &accumulators : streaming) {
+    kwargs.streaming->merge(accumulators);
   }
-  loss /= batcher->size();
-
-  // Tear down indicator
-  indicators::show_console_cursor(true);
-
-  this->setEval(evalMode);
   return std::make_pair(loss, confusionMatrix);
 }
+
+std::pair<float, Eigen::MatrixXi>
+Model::test(const std::shared_ptr<loader::DatasetBatcher> batcher,
+            const std::string &indicatorDescription) {
+  return this->test(batcher, indicatorDescription, TestKeywordArgs());
+}
 #pragma endregion Test
 
 #pragma region Metrics
 void Model::validateMetric(const std::string &metric) {
-  if (metric != "loss" && !metrics::METRICS.contains(metric)) {
+  if (metric != "loss" && !metrics::METRICS.contains(metric) &&
+      !metrics::isStreamingMetric(metric)) {
     throw exceptions::model::InvalidMetricException(metric);
   }
 }
@@ -410,24 +877,44 @@ Model::metricTypesToHistory(const std::vector<std::string> &metrics) {
   return result;
 }
 
-void Model::storeMetrics(
-    std::unordered_map<std::string, metricHistoryValue> &metrics,
-    Eigen::MatrixXi &confusionMatrix, float loss) {
-  for (auto &[metric, history] : metrics) {
+std::unordered_map<std::string, std::variant<float, std::vector<float>>>
+Model::calculateMetrics(
+    const std::unordered_map<std::string, metricHistoryValue> &metrics,
+    const Eigen::MatrixXi &confusionMatrix, float loss,
+    const metrics::StreamingMetrics *streaming) {
+  std::unordered_map<std::string, std::variant<float, std::vector<float>>>
+      result;
+  for (const auto &[metric, history] : metrics) {
     if (metric == "loss") {
-      history.push_back(loss);
+      result[metric] = loss;
+    } else if (metrics::isStreamingMetric(metric)) {
+      if (streaming == nullptr || !streaming->contains(metric)) {
+        throw exceptions::model::MissingStreamingMetricException(metric);
+      }
+      result[metric] = streaming->compute(metric);
     } else {
-      history.push_back(metrics::METRICS.at(metric)(confusionMatrix));
+      result[metric] = metrics::METRICS.at(metric)(confusionMatrix);
     }
   }
+  return result;
+}
+
+void Model::storeMetrics(
+    std::unordered_map<std::string, metricHistoryValue> &metrics,
+    Eigen::MatrixXi &confusionMatrix, float loss,
+    const metrics::StreamingMetrics *streaming) {
+  for (auto &[metric, value] :
+       Model::calculateMetrics(metrics, confusionMatrix, loss, streaming)) {
+    std::visit([&](const auto &x) { metrics[metric].push_back(x); }, value);
+  }
 }
 
 void Model::printMetrics(
     const std::unordered_map<std::string, metricHistoryValue> &metrics,
     const std::vector<std::string> &classes) {
   tabulate::Table::Row_t multiclassHeaders{"Class"}, singularHeaders,
-      singularData;
-  std::vector<std::vector<std::string>> multiclassData{classes};
+      singularData, binnedHeaders{"Confidence"};
+  std::vector<std::vector<std::string>> multiclassData{classes}, binnedData;
   int precision = 4;
 
   // Get the data
@@ -435,14 +922,21 @@ void Model::printMetrics(
     std::string header = utils::string::capitalise(
         utils::string::join(utils::string::split(metric, "_"), " "));
 
-    if (metrics::SINGLE_VALUE_METRICS.contains(metric)) {
+    if (metrics::isSingleValueMetric(metric)) {
       singularHeaders.push_back(header);
-      singularData.push_back(utils::string::floatToString(
-          std::get<float>(history.back()), precision));
+      singularData.push_back(
+          utils::string::floatToString(history.back()[0], precision));
+    } else if (metrics::isStreamingMetric(metric)) {
+      binnedHeaders.push_back(header);
+      std::vector<std::string> values;
+      for (const float &value : history.back()) {
+        values.push_back(utils::string::floatToString(value, precision));
+      }
+      binnedData.push_back(values);
     } else {
       multiclassHeaders.push_back(header);
       std::vector<std::string> values;
-      for (const float &value : std::get<std::vector<float>>(history.back())) {
+      for (const float &value : history.back()) {
         values.push_back(utils::string::floatToString(value, precision));
       }
       multiclassData.push_back(values);
@@ -510,6 +1004,58 @@ void Model::printMetrics(
 
     std::cout << table << std::endl;
   }
+
+  if (!binnedData.empty()) {
+    tabulate::Table table;
+
+    // Add rows, labelling each bin with its range of confidences
+    table.add_row(binnedHeaders);
+    int bins = binnedData[0].size();
+    for (int i = 0; i < bins; ++i) {
+      tabulate::Table::Row_t row{
+          utils::string::floatToString((float)i / bins, 2) + "-" +
+          utils::string::floatToString((float)(i + 1) / bins, 2)};
+      for (const std::vector<std::string> &data : binnedData) {
+        row.push_back(data[i]);
+      }
+      table.add_row(row);
+    }
+    // Style table
+    table.format()
+        .border(" ")
+        .corner(" ")
+        .font_align(tabulate::FontAlign::right)
+        .hide_border_top()
+        .hide_border_bottom();
+    table.row(0)
+        .format()
+        .font_style({tabulate::FontStyle::bold})
+        .font_align(tabulate::FontAlign::center)
+        .show_border_top();
+    table.row(1).format().border_top("-").show_border_top();
+
+    std::cout << table << std::endl;
+  }
+}
+
+json Model::metricsHistoryToJson(
+    const std::unordered_map<std::string, metricHistoryValue> &metrics) {
+  json result;
+  for (const auto &[metric, history] : metrics) {
+    json data = json::array();
+    if (metrics::isSingleValueMetric(metric)) {
+      for (const float &x : history.getValues()) {
+        data.push_back(x);
+      }
+    } else {
+      for (int i = 0; i < history.size(); ++i) {
+        std::span<const float> row = history[i];
+        data.push_back(std::vector<float>(row.begin(), row.end()));
+      }
+    }
+    result[metric] = data;
+  }
+  return result;
 }
 #pragma endregion Metrics
 
@@ -518,7 +1064,7 @@ void Model::plotMetric(
     const std::string &dataset,
     const std::unordered_map<std::string, metricHistoryValue> &metrics,
     const std::string &metric, matplot::axes_handle &axis) const {
-  if (!metrics::SINGLE_VALUE_METRICS.contains(metric)) {
+  if (!metrics::isSingleValueMetric(metric)) {
     throw exceptions::model::InvalidPlottingMetricException(metric);
   }
 
@@ -527,17 +1073,15 @@ void Model::plotMetric(
   }
 
   matplot::axes(axis);
-  std::vector<float> history;
-  for (auto value : metrics.at(metric)) {
-    history.push_back(std::get<float>(value));
-  }
+  std::span<const float> values = metrics.at(metric).getValues();
+  std::vector<float> history(values.begin(), values.end());
   auto x = matplot::iota(1, history.size() + 1);
   matplot::plot(x, history, ".-")
       ->display_name(utils::string::capitalise(dataset));
 }
 
 void Model::generateHistoryGraph(const std::string &metric) const {
-  if (!metrics::SINGLE_VALUE_METRICS.contains(metric)) {
+  if (!metrics::isSingleValueMetric(metric)) {
     return;
   }
 
@@ -549,15 +1093,15 @@ void Model::generateHistoryGraph(const std::string &metric) const {
   matplot::xrange({0, (double)this->totalEpochs + 1});
   double min = INT_MAX, max = INT_MIN;
   if (this->trainMetrics.contains(metric)) {
-    for (auto x : this->trainMetrics.at(metric)) {
-      min = std::min(min, (double)std::get<float>(x));
-      max = std::max(max, (double)std::get<float>(x));
+    for (float x : this->trainMetrics.at(metric).getValues()) {
+      min = std::min(min, (double)x);
+      max = std::max(max, (double)x);
     }
   }
   if (this->validationMetrics.contains(metric)) {
-    for (auto x : this->validationMetrics.at(metric)) {
-      min = std::min(min, (double)std::get<float>(x));
-      max = std::max(max, (double)std::get<float>(x));
+    for (float x : this->validationMetrics.at(metric).getValues()) {
+      min = std::min(min, (double)x);
+      max = std::max(max, (double)x);
     }
   }
   double spacing = (max + min) / 2 * 0.01;
@@ -584,13 +1128,15 @@ void Model::generateHistoryGraph(const std::string &metric) const {
 }
 
 void Model::displayHistoryGraphs() const {
-  std::vector<std::string> visualizableMetrics;
-  for (const std::string &metric : metrics::SINGLE_VALUE_METRICS) {
-    if (this->trainMetrics.contains(metric) ||
-        this->validationMetrics.contains(metric)) {
-      visualizableMetrics.push_back(metric);
+  std::set<std::string> tracked;
+  for (const auto *metrics : {&this->trainMetrics, &this->validationMetrics}) {
+    for (const auto &[metric, _] : *metrics) {
+      if (metrics::isSingleValueMetric(metric)) {
+        tracked.insert(metric);
+      }
     }
   }
+  std::vector<std::string> visualizableMetrics(tracked.begin(), tracked.end());
 
   std::string graphedMetrics = utils::string::joinWithDifferentLast(
                   visualizableMetrics, ", ", " and "),
@@ -1,7 +1,15 @@
 #pragma once
+#include "checkpoint.hpp"
 #include "cross_entropy_loss.hpp"
 #include "linear.hpp"
+#include "lr_scheduler.hpp"
+#include "metric_history.hpp"
+#include "streaming_metrics.hpp"
+#include "utils/allocations.hpp"
+#include "utils/memory.hpp"
+#include "utils/timer.hpp"
 #include <Eigen/Dense>
+#include <cstddef>
 #include <matplot/freestanding/axes_functions.h>
 #include <memory>
 #include <nlohmann/json_fwd.hpp>
@@ -21,7 +29,36 @@ class ImageLoader;
 using json = nlohmann::json;
 
 namespace model {
-typedef std::vector<std::variant<float, std::vector<float>>> metricHistoryValue;
+typedef metrics::MetricHistory metricHistoryValue;
+
+#pragma region Architecture
+/*
+  The width and activation function of a layer.
+*/
+struct LayerConfig {
+  int size;
+  std::string activation = "NoActivation";
+};
+
+/*
+  The layers of the untrained default model, followed by an output layer per
+  class.
+*/
+const std::vector<LayerConfig> DEFAULT_HIDDEN_LAYERS{{250, "ReLU"},
+                                                     {250, "ReLU"}};
+
+/*
+  Create randomly initialised layers from the layer configs, with the first
+  layer taking the given number of inputs and each other layer taking the
+  outputs of the layer before it.
+
+  The last layer is the output layer, so its size must match the number of
+  outputs.
+*/
+std::vector<linear::Linear> buildLayers(int inputs,
+                                        const std::vector<LayerConfig> &layers,
+                                        int outputs);
+#pragma endregion Architecture
 
 class Model {
   bool eval = false;
@@ -49,6 +86,35 @@ public:
     void setValidationMetricsFromMetricTypes(std::vector<std::string> metrics);
   };
 
+  struct TrainKeywordArgs {
+    checkpoint::State start;
+    std::string checkpointPath;
+    int checkpointEpochs = 1;
+    double checkpointMinutes = 0;
+    bool timings = false;
+    utils::timer::StageTimer *timer = nullptr;
+    bool memoryUsage = false;
+    bool allocationCounts = false;
+    std::string metricsLogPath;
+    int metricsLogBatches = 0;
+    int testWorkers = 1;
+    int validationSamples = 0;
+    int fullValidationEpochs = 0;
+    int earlyStoppingPatience = 0;
+    std::string earlyStoppingMetric = "loss";
+    double earlyStoppingMinDelta = 0;
+    bool restoreBestWeights = false;
+    lr_scheduler::Scheduler::KeywordArgs learningRateSchedule;
+    bool verbose = true;
+  };
+
+  struct TestKeywordArgs {
+    int workers = 1;
+    utils::allocations::AllocationTracker *allocations = nullptr;
+    metrics::StreamingMetrics *streaming = nullptr;
+    bool verbose = true;
+  };
+
   Model(std::vector<linear::Linear> layers, loss::CrossEntropyLoss loss,
         const KeywordArgs &kwargs);
   Model(std::vector<linear::Linear> layers, loss::CrossEntropyLoss loss);
@@ -115,9 +181,10 @@ public:
 
 #pragma region Train metrics
   /*
-    Get a copy of the train metrics.
+    Get the train metrics. The reference is invalidated by further training.
   */
-  std::unordered_map<std::string, metricHistoryValue> getTrainMetrics() const;
+  const std::unordered_map<std::string, metricHistoryValue> &
+  getTrainMetrics() const;
   /*
     Set the train metrics.
   */
@@ -131,9 +198,10 @@ public:
 
 #pragma region Validation metrics
   /*
-    Get a copy of the validation metrics.
+    Get the validation metrics. The reference is invalidated by further
+    training.
   */
-  std::unordered_map<std::string, metricHistoryValue>
+  const std::unordered_map<std::string, metricHistoryValue> &
   getValidationMetrics() const;
   /*
     Set the validation metrics.
@@ -145,6 +213,22 @@ public:
   */
   void setValidationMetrics(std::vector<std::string> metrics);
 #pragma endregion Validation metrics
+
+#pragma region Memory
+  /*
+    Get the number of bytes held by the weights and biases of the layers.
+  */
+  std::size_t getParameterSize() const;
+  /*
+    Get the number of bytes held by the activations saved for the backward
+    pass by the layers and the loss.
+  */
+  std::size_t getCacheSize() const;
+  /*
+    Get the number of bytes held by the train and validation metric histories.
+  */
+  std::size_t getMetricHistorySize() const;
+#pragma endregion Memory
 #pragma endregion Properties
 
 #pragma region Load
@@ -152,6 +236,11 @@ public:
     Create a model instance from the given attributes.
   */
   static Model fromJson(const json &data);
+  /*
+    Create a model instance from the given attributes, using the already
+    constructed layers instead of the serialised layers.
+  */
+  static Model fromJson(const json &data, std::vector<linear::Linear> layers);
 
   /*
     Load a model from the given file.
@@ -180,6 +269,14 @@ public:
     Save the model attributes to the provided path.
   */
   void save(const std::string &path) const;
+
+  /*
+    Copy the parameters, metric histories and classes into the snapshot,
+    reusing the snapshot's memory when it has the same layers. The snapshot
+    holds none of the cached activations, so it can be serialised while this
+    model keeps training.
+  */
+  void copyTo(Model &snapshot) const;
 #pragma endregion Save
 
 #pragma region Forward pass
@@ -188,6 +285,12 @@ public:
   */
   Eigen::MatrixXd forward(const Eigen::MatrixXd &input);
 
+  /*
+    Perform the forward pass without saving any inputs for the backward pass,
+    allowing it to be called concurrently.
+  */
+  Eigen::MatrixXd infer(const Eigen::MatrixXd &input) const;
+
   /*
     Perform the forward pass and predict the classes for the input.
   */
@@ -196,21 +299,71 @@ public:
 
 #pragma region Train
   /*
-    Perform the forward pass and store the predictions in the given confusion
-    matrix.
+    Perform the inference pass and store the predictions in the given
+    confusion matrix, and the logits in the streaming metrics if given.
   */
-  float getLossWithConfusionMatrix(const Eigen::MatrixXd &input,
-                                   Eigen::MatrixXi &confusionMatrix,
-                                   const std::vector<int> &labels);
+  float getLossWithConfusionMatrix(
+      const Eigen::MatrixXd &input, Eigen::MatrixXi &confusionMatrix,
+      const std::vector<int> &labels,
+      metrics::StreamingMetrics *streaming = nullptr) const;
 
-private:
   /*
     Perform the training step for one minibatch.
+
+    When a timer is given, the forward, backward and update of each layer, the
+    loss and the metrics are timed as separate stages. When a memory tracker is
+    given, the most gradient bytes held at once is sampled. When streaming
+    metrics are given, they are updated with the logits.
   */
   float trainStep(const Eigen::MatrixXd &data, const std::vector<int> &labels,
-                  double learningRate, Eigen::MatrixXi &confusionMatrix);
+                  double learningRate, Eigen::MatrixXi &confusionMatrix,
+                  utils::timer::StageTimer *timer = nullptr,
+                  utils::memory::MemoryTracker *memory = nullptr,
+                  metrics::StreamingMetrics *streaming = nullptr);
 
-public:
+  /*
+    Train the model for the given number of epochs.
+
+    When a checkpoint path is provided, the model is checkpointed in the
+    background every checkpointEpochs epochs, and after the final epoch. Once
+    checkpointMinutes have passed since the last checkpoint, the model is
+    checkpointed after the current minibatch.
+
+    Training starts from the epoch and minibatch of the start state, shuffling
+    the training data with its seed and continuing from its partial epoch
+    results, allowing a run to be resumed mid-epoch from a checkpoint.
+
+    When timings is set, the time spent loading batches and in each stage of
+    the training step is printed after each epoch's training metrics. The
+    timings are accumulated in the given timer, if any, which is cleared at
+    the start of each epoch. When
+    memoryUsage is set, the steady state and peak bytes held by the weights,
+    gradients, saved activations, loaded batch and metric histories are
+    printed after them. When allocationCounts is set, the heap allocations
+    made per batch while loading, training and validating are printed at the
+    end of each epoch.
+
+    When validationSamples is positive, validation uses a fixed stratified
+    sample of that many test files, and the accuracy's 95% confidence interval
+    is printed. The full test split is still validated on every
+    fullValidationEpochs epochs, if positive, and after the final epoch.
+
+    The learning rate of each minibatch follows the learningRateSchedule,
+    counted from the start of the run so a resumed run continues the schedule.
+
+    When earlyStoppingPatience is positive, training stops once the validation
+    earlyStoppingMetric has not improved by more than earlyStoppingMinDelta
+    for that many epochs in a row. When validationSamples is positive, only
+    the full validations are compared, so the patience counts full
+    validations rather than epochs. When restoreBestWeights is set, the weights
+    of the best epoch are kept in memory and restored once training ends,
+    whether it stopped early or trained for all the epochs.
+
+    When verbose is not set, nothing is printed and no progress bars are drawn,
+    such as when several models are trained at once.
+  */
+  void train(const loader::ImageLoader &loader, double learningRate,
+             int batchSize, int epochs, const TrainKeywordArgs &kwargs);
   /*
     Train the model for the given number of epochs.
   */
@@ -219,6 +372,22 @@ public:
 #pragma endregion Train
 
 #pragma region Test
+  /*
+    Perform test on the model with the given data loader, returning the loss and
+    confusion matrix.
+
+    The batches are shared between the given number of workers, each keeping
+    its own confusion matrix. The losses are summed in batch order, so the
+    results match those of a single worker. When an allocation tracker is
+    given, the allocations made by each test step are recorded. When streaming
+    metrics are given, each worker accumulates its own copy from the logits,
+    and the copies are merged into them. When verbose is not set, no progress
+    bar is drawn.
+  */
+  std::pair<float, Eigen::MatrixXi>
+  test(const std::shared_ptr<loader::DatasetBatcher> loader,
+       const std::string &indicatorDescription,
+       const TestKeywordArgs &kwargs);
   /*
     Perform test on the model with the given data loader, returning the loss and
     confusion matrix.
@@ -249,12 +418,23 @@ public:
   static std::unordered_map<std::string, metricHistoryValue>
   metricTypesToHistory(const std::vector<std::string> &metrics);
 
+  /*
+    Calculate the tracked metrics from the confusion matrix and loss, and the
+    streaming metrics from their accumulators.
+  */
+  static std::unordered_map<std::string, std::variant<float, std::vector<float>>>
+  calculateMetrics(
+      const std::unordered_map<std::string, metricHistoryValue> &metrics,
+      const Eigen::MatrixXi &confusionMatrix, float loss,
+      const metrics::StreamingMetrics *streaming = nullptr);
+
   /*
     Store the metrics.
   */
   static void
   storeMetrics(std::unordered_map<std::string, metricHistoryValue> &metrics,
-               Eigen::MatrixXi &confusionMatrix, float loss);
+               Eigen::MatrixXi &confusionMatrix, float loss,
+               const metrics::StreamingMetrics *streaming = nullptr);
 
   /*
     Print the tracked metrics.
@@ -262,6 +442,13 @@ public:
   static void printMetrics(
       const std::unordered_map<std::string, metricHistoryValue> &metrics,
       const std::vector<std::string> &classes);
+
+  /*
+    Get the metric history in a serialisable format, mapping each metric to
+    its values per epoch.
+  */
+  static json metricsHistoryToJson(
+      const std::unordered_map<std::string, metricHistoryValue> &metrics);
 #pragma endregion Metrics
 
 #pragma region Visualisation
@@ -0,0 +1,244 @@
+#include "model_parser.hpp"
+#include "exceptions/eigen.hpp"
+#include "exceptions/json.hpp"
+#include "exceptions/load.hpp"
+#include "linear.hpp"
+#include <Eigen/Dense>
+#include <nlohmann/json.hpp>
+#include <utility>
+
+using namespace model::parser;
+
+#pragma region Model SAX handler
+#pragma region Helpers
+json *ModelSaxHandler::addValue(json value) {
+  if (this->containers.empty()) {
+    this->document = std::move(value);
+    return &this->document;
+  }
+
+  if (this->containers.back()->is_array()) {
+    this->containers.back()->push_back(std::move(value));
+    return &this->containers.back()->back();
+  }
+
+  *this->objectElement = std::move(value);
+  return this->objectElement;
+}
+
+bool ModelSaxHandler::isParameterArray() const {
+  return this->containers.size() == 3 && this->containerKeys[1] == "layers" &&
+         this->containers[1]->is_array() &&
+         this->containers.back()->is_object() &&
+         (this->currentKey == "weight" || this->currentKey == "bias");
+}
+
+bool ModelSaxHandler::addParameterValue(double value) {
+  if (this->parameter == "weight" && this->depth != 2) {
+    throw exceptions::json::JSONArray2DException();
+  }
+  this->buffer.push_back(value);
+  ++this->rowLength;
+  return true;
+}
+
+void ModelSaxHandler::storeParameter() {
+  int layer = this->containers[1]->size() - 1;
+  if (this->parameters.size() <= layer) {
+    this->parameters.resize(layer + 1);
+  }
+
+  if (this->parameter == "weight") {
+    // The buffer holds the rows contiguously.
+    this->parameters[layer].weight =
+        Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                                       Eigen::RowMajor>>(this->buffer.data(),
+                                                         this->rows,
+                                                         this->cols);
+  } else {
+    this->parameters[layer].bias = Eigen::Map<const Eigen::VectorXd>(
+        this->buffer.data(), this->buffer.size());
+  }
+
+  std::vector<double>().swap(this->buffer);
+  this->parameter.clear();
+}
+#pragma endregion Helpers
+
+#pragma region SAX interface
+bool ModelSaxHandler::null() {
+  if (!this->parameter.empty()) {
+    throw exceptions::json::JSONTypeException();
+  }
+  this->addValue(nullptr);
+  return true;
+}
+
+bool ModelSaxHandler::boolean(bool value) {
+  if (!this->parameter.empty()) {
+    throw exceptions::json::JSONTypeException();
+  }
+  this->addValue(value);
+  return true;
+}
+
+bool ModelSaxHandler::number_integer(json::number_integer_t value) {
+  if (!this->parameter.empty()) {
+    return this->addParameterValue(value);
+  }
+  this->addValue(value);
+  return true;
+}
+
+bool ModelSaxHandler::number_unsigned(json::number_unsigned_t value) {
+  if (!this->parameter.empty()) {
+    return this->addParameterValue(value);
+  }
+  this->addValue(value);
+  return true;
+}
+
+bool ModelSaxHandler::number_float(json::number_float_t value,
+                                   const json::string_t &) {
+  if (!this->parameter.empty()) {
+    return this->addParameterValue(value);
+  }
+  this->addValue(value);
+  return true;
+}
+
+bool ModelSaxHandler::string(json::string_t &value) {
+  if (!this->parameter.empty()) {
+    throw exceptions::json::JSONTypeException();
+  }
+  this->addValue(std::move(value));
+  return true;
+}
+
+bool ModelSaxHandler::binary(json::binary_t &value) {
+  if (!this->parameter.empty()) {
+    throw exceptions::json::JSONTypeException();
+  }
+  this->addValue(std::move(value));
+  return true;
+}
+
+bool ModelSaxHandler::start_object(std::size_t) {
+  if (!this->parameter.empty()) {
+    throw exceptions::json::JSONTypeException();
+  }
+  bool inObject =
+      !this->containers.empty() && this->containers.back()->is_object();
+  this->containerKeys.push_back(inObject ? this->currentKey : "");
+  this->containers.push_back(this->addValue(json::object()));
+  return true;
+}
+
+bool ModelSaxHandler::key(json::string_t &value) {
+  this->currentKey = value;
+  this->objectElement = &(*this->containers.back())[value];
+  return true;
+}
+
+bool ModelSaxHandler::end_object() {
+  this->containers.pop_back();
+  this->containerKeys.pop_back();
+  return true;
+}
+
+bool ModelSaxHandler::start_array(std::size_t) {
+  if (!this->parameter.empty()) {
+    if (this->parameter == "bias") {
+      throw exceptions::json::JSONArray1DException();
+    }
+    if (++this->depth > 2) {
+      throw exceptions::json::JSONArray2DException();
+    }
+    this->rowLength = 0;
+    return true;
+  }
+
+  if (this->isParameterArray()) {
+    this->containers.back()->erase(this->currentKey);
+    this->parameter = this->currentKey;
+    this->depth = 1;
+    this->rows = this->cols = this->rowLength = 0;
+    return true;
+  }
+
+  bool inObject =
+      !this->containers.empty() && this->containers.back()->is_object();
+  this->containerKeys.push_back(inObject ? this->currentKey : "");
+  this->containers.push_back(this->addValue(json::array()));
+  return true;
+}
+
+bool ModelSaxHandler::end_array() {
+  if (this->parameter.empty()) {
+    this->containers.pop_back();
+    this->containerKeys.pop_back();
+    return true;
+  }
+
+  if (this->parameter == "weight" && this->depth == 2) {
+    if (this->rows == 0) {
+      this->cols = this->rowLength;
+    } else if (this->rowLength != this->cols) {
+      throw exceptions::json::JSONArray2DException();
+    }
+    ++this->rows;
+  }
+  if (--this->depth == 0) {
+    this->storeParameter();
+  }
+  return true;
+}
+#pragma endregion SAX interface
+
+#pragma region Results
+json &ModelSaxHandler::getDocument() { return this->document; }
+
+std::vector<linear::Linear> ModelSaxHandler::getLayers() {
+  const json &values = this->document;
+  const json &layersData = values["layers"];
+  std::vector<linear::Linear> layers;
+  layers.reserve(layersData.size());
+  for (int i = 0; i < layersData.size(); ++i) {
+    const json &layerData = layersData[i];
+    if (layerData["class"] != "Linear") {
+      throw exceptions::load::InvalidClassAttributeValue();
+    }
+    if (layerData.contains("weight") || layerData.contains("bias")) {
+      // Parameters are only streamed when they are arrays.
+      throw exceptions::json::JSONTypeException();
+    }
+
+    // A layer without streamed parameters is missing its weight or bias.
+    if (i >= this->parameters.size() ||
+        this->parameters[i].weight.size() == 0 ||
+        this->parameters[i].bias.size() == 0) {
+      throw exceptions::json::JSONTypeException();
+    }
+    LayerParameters parameters = std::move(this->parameters[i]);
+    if (!layers.empty() &&
+        parameters.weight.cols() != layers.back().outChannels) {
+      throw exceptions::eigen::InvalidShapeException(
+          Eigen::MatrixXd(parameters.weight.rows(), layers.back().outChannels),
+          parameters.weight);
+    }
+    layers.emplace_back(std::move(parameters.weight),
+                        std::move(parameters.bias),
+                        layerData["activation_function"].get<std::string>());
+  }
+  return layers;
+}
+#pragma endregion Results
+#pragma endregion Model SAX handler
+
+std::pair<json, std::vector<linear::Linear>>
+model::parser::parse(std::istream &stream) {
+  ModelSaxHandler handler;
+  json::sax_parse(stream, &handler);
+  std::vector<linear::Linear> layers = handler.getLayers();
+  return std::make_pair(std::move(handler.getDocument()), std::move(layers));
+}
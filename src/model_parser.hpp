@@ -0,0 +1,100 @@
+#pragma once
+#include "linear.hpp"
+#include <Eigen/Dense>
+#include <cstddef>
+#include <istream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace model::parser {
+#pragma region Model SAX handler
+/*
+  SAX handler for the saved model format.
+
+  The weight and bias arrays of each layer are streamed directly into dense
+  storage instead of being built as JSON values. All other attributes are small
+  and are collected into a JSON document.
+*/
+class ModelSaxHandler {
+  struct LayerParameters {
+    Eigen::MatrixXd weight;
+    Eigen::VectorXd bias;
+  };
+
+  json document;
+  std::vector<json *> containers;
+  std::vector<std::string> containerKeys;
+  json *objectElement = nullptr;
+  std::string currentKey;
+
+  // Parameter streaming state
+  std::vector<LayerParameters> parameters;
+  std::vector<double> buffer;
+  std::string parameter;
+  int depth = 0, rows = 0, cols = 0, rowLength = 0;
+
+  /*
+    Add the value to the document, returning the stored value.
+  */
+  json *addValue(json value);
+
+  /*
+    Whether the next array is the weight or bias of a layer.
+  */
+  bool isParameterArray() const;
+
+  /*
+    Store a number from a parameter array.
+  */
+  bool addParameterValue(double value);
+
+  /*
+    Move the streamed parameter into the current layer's storage.
+  */
+  void storeParameter();
+
+public:
+#pragma region SAX interface
+  bool null();
+  bool boolean(bool value);
+  bool number_integer(json::number_integer_t value);
+  bool number_unsigned(json::number_unsigned_t value);
+  bool number_float(json::number_float_t value, const json::string_t &);
+  bool string(json::string_t &value);
+  bool binary(json::binary_t &value);
+  bool start_object(std::size_t);
+  bool key(json::string_t &value);
+  bool end_object();
+  bool start_array(std::size_t);
+  bool end_array();
+
+  template <typename Exception>
+  bool parse_error(std::size_t, const std::string &, const Exception &ex) {
+    throw ex;
+  }
+#pragma endregion SAX interface
+
+#pragma region Results
+  /*
+    Get the parsed attributes, excluding the layer parameters.
+  */
+  json &getDocument();
+
+  /*
+    Build the layers from the parsed attributes and streamed parameters.
+  */
+  std::vector<linear::Linear> getLayers();
+#pragma endregion Results
+};
+#pragma endregion Model SAX handler
+
+/*
+  Parse a saved model from the stream, returning the model attributes without
+  the layer parameters and the constructed layers.
+*/
+std::pair<json, std::vector<linear::Linear>> parse(std::istream &stream);
+} // namespace model::parser
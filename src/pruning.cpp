@@ -0,0 +1,246 @@
+#include "pruning.hpp"
+#include "activation_functions.hpp"
+#include "exceptions/model.hpp"
+#include "exceptions/pruning.hpp"
+#include "linear.hpp"
+#include "metrics.hpp"
+#include "utils/math.hpp"
+#include "utils/string.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <tabulate/table.hpp>
+
+using namespace pruning;
+
+#pragma region Helpers
+/*
+  Get the given rows of the matrix, in order.
+*/
+static Eigen::MatrixXd selectRows(const Eigen::MatrixXd &matrix,
+                                  const std::vector<int> &rows) {
+  Eigen::MatrixXd result(rows.size(), matrix.cols());
+  for (int i = 0; i < rows.size(); ++i) {
+    result.row(i) = matrix.row(rows[i]);
+  }
+  return result;
+}
+
+/*
+  Get the given columns of the matrix, in order.
+*/
+static Eigen::MatrixXd selectCols(const Eigen::MatrixXd &matrix,
+                                  const std::vector<int> &cols) {
+  Eigen::MatrixXd result(matrix.rows(), cols.size());
+  for (int i = 0; i < cols.size(); ++i) {
+    result.col(i) = matrix.col(cols[i]);
+  }
+  return result;
+}
+#pragma endregion Helpers
+
+Criterion pruning::criterionFromString(const std::string &criterion) {
+  if (criterion == "weight") {
+    return Criterion::WEIGHT;
+  } else if (criterion == "activation") {
+    return Criterion::ACTIVATION;
+  }
+  throw exceptions::pruning::InvalidCriterionException(criterion);
+}
+
+#pragma region Prune
+std::vector<Eigen::VectorXd> pruning::scoreUnits(
+    const model::Model &model,
+    const std::shared_ptr<loader::DatasetBatcher> calibrationData,
+    const KeywordArgs &kwargs) {
+  std::vector<linear::Linear> layers = model.getLayers();
+  std::vector<Eigen::VectorXd> scores;
+  for (int i = 0; i + 1 < layers.size(); ++i) {
+    scores.push_back(layers[i + 1].getWeight().colwise().norm().transpose());
+  }
+
+  if (kwargs.criterion == Criterion::WEIGHT) {
+    for (int i = 0; i < scores.size(); ++i) {
+      scores[i] =
+          scores[i].cwiseProduct(layers[i].getWeight().rowwise().norm());
+    }
+    return scores;
+  }
+
+  if (kwargs.calibrationBatches < 1) {
+    throw exceptions::pruning::InvalidCalibrationBatchesException(
+        kwargs.calibrationBatches);
+  }
+
+  // Find the mean output magnitude of each hidden unit
+  std::vector<Eigen::VectorXd> activations;
+  for (const Eigen::VectorXd &score : scores) {
+    activations.push_back(Eigen::VectorXd::Zero(score.size()));
+  }
+  for (linear::Linear &layer : layers) {
+    layer.setEval(true);
+  }
+  int batches = std::min(kwargs.calibrationBatches, calibrationData->size()),
+      samples = 0;
+  for (int i = 0; i < batches; ++i) {
+    Eigen::MatrixXd out = (*calibrationData)[i].first;
+    samples += out.rows();
+    for (int j = 0; j < activations.size(); ++j) {
+      out = layers[j](out);
+      activations[j] += out.cwiseAbs().colwise().sum().transpose();
+    }
+  }
+  for (int i = 0; i < scores.size(); ++i) {
+    scores[i] = scores[i].cwiseProduct(activations[i] / std::max(samples, 1));
+  }
+  return scores;
+}
+
+model::Model
+pruning::prune(const model::Model &model, double sparsity,
+               const std::shared_ptr<loader::DatasetBatcher> calibrationData,
+               const KeywordArgs &kwargs) {
+  if (sparsity < 0 || sparsity >= 1) {
+    throw exceptions::pruning::InvalidSparsityException(sparsity);
+  }
+
+  std::vector<Eigen::VectorXd> scores =
+      scoreUnits(model, calibrationData, kwargs);
+  std::vector<linear::Linear> layers = model.getLayers();
+  Eigen::MatrixXd nextWeight = layers.front().getWeight();
+  std::vector<linear::Linear> prunedLayers;
+  for (int i = 0; i < layers.size(); ++i) {
+    Eigen::MatrixXd weight = nextWeight;
+    Eigen::VectorXd bias = layers[i].getBias();
+    std::string activation = layers[i].getActivation()->getName();
+    if (i + 1 == layers.size()) {
+      prunedLayers.push_back(linear::Linear(weight, bias, activation));
+      break;
+    }
+
+    // Keep the highest scoring units in their original order
+    const Eigen::VectorXd &score = scores[i];
+    int units = score.size(),
+        keep = std::max((int)std::round(units * (1 - sparsity)), 1);
+    std::vector<int> order(units);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return score[a] > score[b]; });
+    std::vector<int> kept(order.begin(), order.begin() + keep);
+    std::sort(kept.begin(), kept.end());
+
+    prunedLayers.push_back(linear::Linear(selectRows(weight, kept),
+                                          selectRows(bias, kept), activation));
+    nextWeight = selectCols(layers[i + 1].getWeight(), kept);
+  }
+
+  model::Model pruned = model;
+  pruned.setLayers(prunedLayers);
+  return pruned;
+}
+
+model::Model
+pruning::prune(const model::Model &model, double sparsity,
+               const std::shared_ptr<loader::DatasetBatcher> calibrationData) {
+  return pruning::prune(model, sparsity, calibrationData, KeywordArgs());
+}
+#pragma endregion Prune
+
+#pragma region Report
+Report pruning::compare(const model::Model &model, const model::Model &pruned,
+                        const std::shared_ptr<loader::DatasetBatcher> batcher) {
+  if (model.getClasses().empty()) {
+    throw exceptions::model::MissingClassesException();
+  }
+
+  Report report;
+  Eigen::MatrixXi confusionMatrix =
+                      metrics::getNewConfusionMatrix(model.getClasses().size()),
+                  prunedConfusionMatrix = confusionMatrix;
+  int agreed = 0, total = 0;
+  for (const auto &[data, labels] : *batcher) {
+    std::vector<int> predictions =
+                         utils::math::logitsToPrediction(model.infer(data)),
+                     prunedPredictions =
+                         utils::math::logitsToPrediction(pruned.infer(data));
+    metrics::addToConfusionMatrix(confusionMatrix, predictions, labels);
+    metrics::addToConfusionMatrix(prunedConfusionMatrix, prunedPredictions,
+                                  labels);
+
+    for (int i = 0; i < predictions.size(); ++i) {
+      agreed += predictions[i] == prunedPredictions[i];
+    }
+    total += predictions.size();
+  }
+  if (total > 0) {
+    report.accuracy = metrics::accuracy(confusionMatrix);
+    report.prunedAccuracy = metrics::accuracy(prunedConfusionMatrix);
+    report.agreement = (float)agreed / total;
+  }
+  auto describe = [](const model::Model &model, std::vector<int> &widths,
+                     std::size_t &size) {
+    std::vector<linear::Linear> layers = model.getLayers();
+    widths.push_back(layers.front().inChannels);
+    for (const linear::Linear &layer : layers) {
+      widths.push_back(layer.outChannels);
+    }
+    size = model.getParameterSize();
+  };
+  describe(model, report.widths, report.size);
+  describe(pruned, report.prunedWidths, report.prunedSize);
+  return report;
+}
+
+void pruning::printReport(const Report &report) {
+  int precision = 4;
+  auto toKilobytes = [&](std::size_t bytes) {
+    return utils::string::floatToString(bytes / 1024.0, precision);
+  };
+  auto toString = [](const std::vector<int> &widths) {
+    std::vector<std::string> words;
+    for (int width : widths) {
+      words.push_back(std::to_string(width));
+    }
+    return utils::string::join(words, "-");
+  };
+
+  tabulate::Table table;
+  table.add_row({"", "Model", "Pruned", "Delta"});
+  table.add_row({"Layers", toString(report.widths),
+                 toString(report.prunedWidths), ""});
+  table.add_row(
+      {"Accuracy", utils::string::floatToString(report.accuracy, precision),
+       utils::string::floatToString(report.prunedAccuracy, precision),
+       utils::string::floatToString(report.prunedAccuracy - report.accuracy,
+                                    precision)});
+  table.add_row({"Size (KB)", toKilobytes(report.size),
+                 toKilobytes(report.prunedSize),
+                 utils::string::floatToString(
+                     report.prunedSize > 0
+                         ? (float)report.size / report.prunedSize
+                         : 0,
+                     precision) +
+                     "x smaller"});
+
+  // Style table
+  table.format()
+      .border(" ")
+      .corner(" ")
+      .font_align(tabulate::FontAlign::right)
+      .hide_border_top()
+      .hide_border_bottom();
+  table.row(0)
+      .format()
+      .font_style({tabulate::FontStyle::bold})
+      .font_align(tabulate::FontAlign::center)
+      .show_border_top();
+  table.row(1).format().border_top("-").show_border_top();
+
+  std::cout << table << std::endl;
+  std::cout << "Prediction agreement: "
+            << utils::string::floatToString(report.agreement, precision)
+            << std::endl;
+}
+#pragma endregion Report
@@ -0,0 +1,81 @@
+#pragma once
+#include "image_loader.hpp"
+#include "model.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pruning {
+/*
+  How the hidden units are ranked for pruning.
+
+  Criteria:
+          - WEIGHT -- the norm of the unit's incoming weights times the norm of
+          its outgoing weights
+          - ACTIVATION -- the mean magnitude of the unit's output on the
+          calibration data times the norm of its outgoing weights
+*/
+enum class Criterion { WEIGHT, ACTIVATION };
+
+/*
+  Get the criterion from its name, being weight or activation.
+*/
+Criterion criterionFromString(const std::string &criterion);
+
+#pragma region Prune
+struct KeywordArgs {
+  Criterion criterion = Criterion::WEIGHT;
+  int calibrationBatches = 10;
+};
+
+/*
+  Score each unit of each hidden layer, where a higher score is more
+  important. The activation criterion runs the first calibrationBatches
+  batches of the calibration data through the model.
+*/
+std::vector<Eigen::VectorXd>
+scoreUnits(const model::Model &model,
+           const std::shared_ptr<loader::DatasetBatcher> calibrationData,
+           const KeywordArgs &kwargs);
+
+/*
+  Prune the given fraction of the units of each hidden layer, keeping the
+  highest scoring units and at least one unit per layer.
+
+  The rows of a pruned unit are removed from its layer's weight and bias, and
+  its column from the next layer's weight, so the pruned model is a smaller
+  dense model rather than a masked one. The output layer is not pruned. The
+  calibration data is only read by the activation criterion.
+*/
+model::Model
+prune(const model::Model &model, double sparsity,
+      const std::shared_ptr<loader::DatasetBatcher> calibrationData,
+      const KeywordArgs &kwargs);
+model::Model
+prune(const model::Model &model, double sparsity,
+      const std::shared_ptr<loader::DatasetBatcher> calibrationData);
+#pragma endregion Prune
+
+#pragma region Report
+/*
+  Comparison of the pruned model against the model it was pruned from.
+*/
+struct Report {
+  float accuracy = 0, prunedAccuracy = 0, agreement = 0;
+  std::vector<int> widths, prunedWidths;
+  std::size_t size = 0, prunedSize = 0;
+};
+
+/*
+  Compare the predictions of the model and its pruned model on the data.
+*/
+Report compare(const model::Model &model, const model::Model &pruned,
+               const std::shared_ptr<loader::DatasetBatcher> batcher);
+
+/*
+  Print the comparison report.
+*/
+void printReport(const Report &report);
+#pragma endregion Report
+} // namespace pruning
@@ -0,0 +1,456 @@
+#include "quantisation.hpp"
+#include "activation_functions.hpp"
+#include "exceptions/activation_functions.hpp"
+#include "exceptions/eigen.hpp"
+#include "exceptions/json.hpp"
+#include "exceptions/load.hpp"
+#include "exceptions/model.hpp"
+#include "exceptions/quantisation.hpp"
+#include "metrics.hpp"
+#include "utils/math.hpp"
+#include "utils/matrix.hpp"
+#include "utils/string.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <tabulate/table.hpp>
+#include <utility>
+
+using namespace quantisation;
+
+#pragma region Helpers
+/*
+  Get the symmetric int8 scale for values with the given maximum magnitude.
+*/
+static float getScale(double maxMagnitude) {
+  return maxMagnitude > 0 ? maxMagnitude / 127 : 1;
+}
+
+/*
+  Multiply the int8 rows of a (m x k) by the int8 rows of b (n x k),
+  accumulating in int32 and passing each result to the epilogue.
+
+  Four rows of a are processed together so that each row of b is read once for
+  every four outputs.
+*/
+template <typename Epilogue>
+static void gemm(const std::int8_t *a, const std::int8_t *b, int m, int n,
+                 int k, Epilogue epilogue) {
+  int i = 0;
+  for (; i + 4 <= m; i += 4) {
+    const std::int8_t *a0 = a + i * k, *a1 = a0 + k, *a2 = a1 + k,
+                      *a3 = a2 + k;
+    for (int j = 0; j < n; ++j) {
+      const std::int8_t *row = b + j * k;
+      std::int32_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+      for (int p = 0; p < k; ++p) {
+        std::int32_t value = row[p];
+        c0 += a0[p] * value;
+        c1 += a1[p] * value;
+        c2 += a2[p] * value;
+        c3 += a3[p] * value;
+      }
+      epilogue(i, j, c0);
+      epilogue(i + 1, j, c1);
+      epilogue(i + 2, j, c2);
+      epilogue(i + 3, j, c3);
+    }
+  }
+
+  for (; i < m; ++i) {
+    const std::int8_t *a0 = a + i * k;
+    for (int j = 0; j < n; ++j) {
+      const std::int8_t *row = b + j * k;
+      std::int32_t c0 = 0;
+      for (int p = 0; p < k; ++p) {
+        c0 += a0[p] * row[p];
+      }
+      epilogue(i, j, c0);
+    }
+  }
+}
+#pragma endregion Helpers
+
+#pragma region Quantised linear
+#pragma region Constructor
+QuantisedLinear::QuantisedLinear(MatrixXi8 weight, Eigen::VectorXf weightScales,
+                                 Eigen::VectorXf bias, float inputScale,
+                                 const std::string &activation)
+    : weight(std::move(weight)), weightScales(std::move(weightScales)),
+      bias(std::move(bias)), inputScale(inputScale), activation(activation),
+      inChannels(this->weight.cols()), outChannels(this->weight.rows()) {
+  if (this->weightScales.rows() != this->outChannels) {
+    throw exceptions::eigen::InvalidShapeException(
+        Eigen::VectorXf(this->outChannels), this->weightScales);
+  }
+  if (this->bias.rows() != this->outChannels) {
+    throw exceptions::eigen::InvalidShapeException(
+        Eigen::VectorXf(this->outChannels), this->bias);
+  }
+  if (activation != "NoActivation" && activation != "ReLU") {
+    throw exceptions::activation::InvalidActivationException(activation);
+  }
+}
+
+QuantisedLinear QuantisedLinear::quantise(const linear::Linear &layer,
+                                          float inputScale) {
+  Eigen::MatrixXd weight = layer.getWeight();
+  Eigen::VectorXf scales(weight.rows());
+  for (int i = 0; i < weight.rows(); ++i) {
+    scales[i] = getScale(weight.row(i).cwiseAbs().maxCoeff());
+  }
+
+  MatrixXi8 quantised =
+      (weight.array().colwise() / scales.cast<double>().array())
+          .round()
+          .cast<std::int8_t>();
+  return QuantisedLinear(std::move(quantised), std::move(scales),
+                         layer.getBias().cast<float>(), inputScale,
+                         layer.getActivation()->getName());
+}
+#pragma endregion Constructor
+
+#pragma region Properties
+#pragma region Weight
+MatrixXi8 QuantisedLinear::getWeight() const { return this->weight; }
+
+Eigen::VectorXf QuantisedLinear::getWeightScales() const {
+  return this->weightScales;
+}
+#pragma endregion Weight
+
+#pragma region Bias
+Eigen::VectorXf QuantisedLinear::getBias() const { return this->bias; }
+#pragma endregion Bias
+
+#pragma region Input scale
+float QuantisedLinear::getInputScale() const { return this->inputScale; }
+#pragma endregion Input scale
+
+#pragma region Activation function
+std::string QuantisedLinear::getActivation() const { return this->activation; }
+#pragma endregion Activation function
+
+#pragma region Size
+std::size_t QuantisedLinear::getSize() const {
+  return this->weight.size() * sizeof(std::int8_t) +
+         (this->weightScales.size() + this->bias.size() + 1) * sizeof(float);
+}
+#pragma endregion Size
+#pragma endregion Properties
+
+#pragma region Load
+QuantisedLinear QuantisedLinear::fromJson(const json &values) {
+  if (values["class"] != "QuantisedLinear") {
+    throw exceptions::load::InvalidClassAttributeValue();
+  }
+
+  // Only integers in the quantised range convert to int8 exactly
+  Eigen::ArrayXXd weight = utils::matrix::fromJson(values["weight"]).array();
+  if (!(weight == weight.round()).all() || !(weight.abs() <= 127).all()) {
+    throw exceptions::json::JSONTypeException();
+  }
+
+  return QuantisedLinear(
+      weight.matrix().cast<std::int8_t>(),
+      utils::matrix::vectorFromJson(values["weight_scales"]).cast<float>(),
+      utils::matrix::vectorFromJson(values["bias"]).cast<float>(),
+      values["input_scale"], values["activation_function"].get<std::string>());
+}
+#pragma endregion Load
+
+#pragma region Save
+json QuantisedLinear::toJson() const {
+  return {
+      {"class", "QuantisedLinear"},
+      {"weight", utils::matrix::toJson(this->weight.cast<int>())},
+      {"weight_scales", utils::matrix::toJson(this->weightScales.transpose())[0]},
+      {"bias", utils::matrix::toJson(this->bias.transpose())[0]},
+      {"input_scale", this->inputScale},
+      {"activation_function", this->activation}};
+}
+#pragma endregion Save
+
+#pragma region Forward pass
+RowMatrixXf QuantisedLinear::forward(const RowMatrixXf &input) const {
+  if (input.cols() != this->inChannels) {
+    throw exceptions::eigen::InvalidShapeException(
+        RowMatrixXf(input.rows(), this->inChannels), input);
+  }
+
+  MatrixXi8 quantised = (input.array() / this->inputScale)
+                            .round()
+                            .max(-127.0f)
+                            .min(127.0f)
+                            .cast<std::int8_t>();
+  Eigen::VectorXf scales = this->weightScales * this->inputScale;
+  bool relu = this->activation == "ReLU";
+
+  RowMatrixXf output(input.rows(), this->outChannels);
+  gemm(quantised.data(), this->weight.data(), input.rows(), this->outChannels,
+       this->inChannels, [&](int i, int j, std::int32_t accumulator) {
+         float value = accumulator * scales[j] + this->bias[j];
+         output(i, j) = relu ? std::max(value, 0.0f) : value;
+       });
+  return output;
+}
+#pragma endregion Forward pass
+
+#pragma region Builtins
+bool QuantisedLinear::operator==(const QuantisedLinear &other) const {
+  return this->weight == other.weight &&
+         this->weightScales.isApprox(other.weightScales) &&
+         this->bias.isApprox(other.bias) &&
+         this->inputScale == other.inputScale &&
+         this->activation == other.activation;
+}
+#pragma endregion Builtins
+#pragma endregion Quantised linear
+
+#pragma region Quantised model
+#pragma region Constructor
+QuantisedModel::QuantisedModel(std::vector<QuantisedLinear> layers,
+                               std::vector<std::string> classes)
+    : layers(std::move(layers)), classes(std::move(classes)) {
+  if (this->layers.empty()) {
+    throw exceptions::model::EmptyLayersVectorException();
+  }
+}
+
+QuantisedModel QuantisedModel::quantise(
+    const model::Model &model,
+    const std::shared_ptr<loader::DatasetBatcher> calibrationData,
+    int calibrationBatches) {
+  if (calibrationBatches < 1) {
+    throw exceptions::quantisation::InvalidCalibrationBatchesException(
+        calibrationBatches);
+  }
+
+  // Find the largest input magnitude seen by each layer.
+  std::vector<linear::Linear> layers = model.getLayers();
+  std::vector<double> maxInputs(layers.size(), 0);
+  for (linear::Linear &layer : layers) {
+    layer.setEval(true);
+  }
+  int batches = std::min(calibrationBatches, calibrationData->size());
+  for (int i = 0; i < batches; ++i) {
+    Eigen::MatrixXd out = (*calibrationData)[i].first;
+    for (int j = 0; j < layers.size(); ++j) {
+      maxInputs[j] = std::max(maxInputs[j], out.cwiseAbs().maxCoeff());
+      out = layers[j](out);
+    }
+  }
+
+  std::vector<QuantisedLinear> quantisedLayers;
+  for (int i = 0; i < layers.size(); ++i) {
+    quantisedLayers.push_back(
+        QuantisedLinear::quantise(layers[i], getScale(maxInputs[i])));
+  }
+  return QuantisedModel(std::move(quantisedLayers), model.getClasses());
+}
+#pragma endregion Constructor
+
+#pragma region Properties
+#pragma region Layers
+std::vector<QuantisedLinear> QuantisedModel::getLayers() const {
+  return this->layers;
+}
+#pragma endregion Layers
+
+#pragma region Classes
+std::vector<std::string> QuantisedModel::getClasses() const {
+  return this->classes;
+}
+#pragma endregion Classes
+
+#pragma region Size
+std::size_t QuantisedModel::getSize() const {
+  std::size_t size = 0;
+  for (const QuantisedLinear &layer : this->layers) {
+    size += layer.getSize();
+  }
+  return size;
+}
+#pragma endregion Size
+#pragma endregion Properties
+
+#pragma region Load
+QuantisedModel QuantisedModel::fromJson(const json &values) {
+  if (values["class"] != "QuantisedModel") {
+    throw exceptions::load::InvalidClassAttributeValue();
+  }
+
+  std::vector<QuantisedLinear> layers;
+  for (const json &layerData : values["layers"]) {
+    layers.push_back(QuantisedLinear::fromJson(layerData));
+  }
+  return QuantisedModel(std::move(layers), values["classes"]);
+}
+
+QuantisedModel QuantisedModel::load(const std::string &path) {
+  std::filesystem::path filePath(path);
+  if (filePath.extension() != ".json") {
+    throw exceptions::model::InvalidExtensionException(filePath.extension());
+  }
+
+  std::ifstream file(filePath);
+  return QuantisedModel::fromJson(json::parse(file));
+}
+#pragma endregion Load
+
+#pragma region Save
+json QuantisedModel::toJson() const {
+  json layers = json::array();
+  for (const QuantisedLinear &layer : this->layers) {
+    layers.push_back(layer.toJson());
+  }
+
+  return {{"class", "QuantisedModel"},
+          {"layers", layers},
+          {"classes", this->classes}};
+}
+
+void QuantisedModel::save(const std::string &path) const {
+  std::filesystem::path savePath(path);
+  if (savePath.extension() != ".json") {
+    throw exceptions::model::InvalidExtensionException(savePath.extension());
+  }
+
+  std::ofstream file(savePath);
+  file << this->toJson().dump();
+  file.close();
+}
+#pragma endregion Save
+
+#pragma region Forward pass
+Eigen::MatrixXd QuantisedModel::forward(const Eigen::MatrixXd &input) const {
+  RowMatrixXf out = input.cast<float>();
+  for (const QuantisedLinear &layer : this->layers) {
+    out = layer.forward(out);
+  }
+  return out.cast<double>();
+}
+
+std::vector<std::string>
+QuantisedModel::predict(const Eigen::MatrixXd &input) const {
+  if (this->classes.empty()) {
+    throw exceptions::model::MissingClassesException();
+  }
+  std::vector<int> predictions =
+      utils::math::logitsToPrediction(this->forward(input));
+  std::vector<std::string> result;
+  for (int prediction : predictions) {
+    result.push_back(this->classes[prediction]);
+  }
+  return result;
+}
+#pragma endregion Forward pass
+
+#pragma region Builtins
+Eigen::MatrixXd QuantisedModel::operator()(const Eigen::MatrixXd &input) const {
+  return this->forward(input);
+}
+
+bool QuantisedModel::operator==(const QuantisedModel &other) const {
+  return this->layers == other.layers && this->classes == other.classes;
+}
+#pragma endregion Builtins
+#pragma endregion Quantised model
+
+#pragma region Report
+Report quantisation::compare(
+    model::Model &model, const QuantisedModel &quantised,
+    const std::shared_ptr<loader::DatasetBatcher> batcher) {
+  if (model.getClasses().empty()) {
+    throw exceptions::model::MissingClassesException();
+  }
+
+  bool evalMode = model.getEval();
+  model.setEval(true);
+
+  Report report;
+  Eigen::MatrixXi confusionMatrix =
+                      metrics::getNewConfusionMatrix(model.getClasses().size()),
+                  quantisedConfusionMatrix = confusionMatrix;
+  int agreed = 0, total = 0;
+  for (const auto &[data, labels] : *batcher) {
+    Eigen::MatrixXd logits = model.forward(data),
+                    quantisedLogits = quantised.forward(data);
+    std::vector<int> predictions = utils::math::logitsToPrediction(logits),
+                     quantisedPredictions =
+                         utils::math::logitsToPrediction(quantisedLogits);
+    metrics::addToConfusionMatrix(confusionMatrix, predictions, labels);
+    metrics::addToConfusionMatrix(quantisedConfusionMatrix,
+                                  quantisedPredictions, labels);
+
+    for (int i = 0; i < predictions.size(); ++i) {
+      agreed += predictions[i] == quantisedPredictions[i];
+    }
+    total += predictions.size();
+    report.maxLogitError =
+        std::max(report.maxLogitError,
+                 (logits - quantisedLogits).cwiseAbs().maxCoeff());
+  }
+  model.setEval(evalMode);
+
+  if (total > 0) {
+    report.accuracy = metrics::accuracy(confusionMatrix);
+    report.quantisedAccuracy = metrics::accuracy(quantisedConfusionMatrix);
+    report.agreement = (float)agreed / total;
+  }
+  for (const linear::Linear &layer : model.getLayers()) {
+    report.size += (layer.getWeight().size() + layer.getBias().size()) *
+                   sizeof(double);
+  }
+  report.quantisedSize = quantised.getSize();
+  return report;
+}
+
+void quantisation::printReport(const Report &report) {
+  int precision = 4;
+  auto toKilobytes = [&](std::size_t bytes) {
+    return utils::string::floatToString(bytes / 1024.0, precision);
+  };
+
+  tabulate::Table table;
+  table.add_row({"", "Model", "Quantised", "Delta"});
+  table.add_row(
+      {"Accuracy", utils::string::floatToString(report.accuracy, precision),
+       utils::string::floatToString(report.quantisedAccuracy, precision),
+       utils::string::floatToString(report.quantisedAccuracy - report.accuracy,
+                                    precision)});
+  table.add_row({"Size (KB)", toKilobytes(report.size),
+                 toKilobytes(report.quantisedSize),
+                 utils::string::floatToString(
+                     report.quantisedSize > 0
+                         ? (float)report.size / report.quantisedSize
+                         : 0,
+                     precision) +
+                     "x smaller"});
+
+  // Style table
+  table.format()
+      .border(" ")
+      .corner(" ")
+      .font_align(tabulate::FontAlign::right)
+      .hide_border_top()
+      .hide_border_bottom();
+  table.row(0)
+      .format()
+      .font_style({tabulate::FontStyle::bold})
+      .font_align(tabulate::FontAlign::center)
+      .show_border_top();
+  table.row(1).format().border_top("-").show_border_top();
+
+  std::cout << table << std::endl;
+  std::cout << "Prediction agreement: "
+            << utils::string::floatToString(report.agreement, precision)
+            << std::endl;
+  std::cout << "Max logit error: "
+            << utils::string::floatToString(report.maxLogitError, precision)
+            << std::endl;
+}
+#pragma endregion Report
\ No newline at end of file
@@ -0,0 +1,239 @@
+#pragma once
+#include "image_loader.hpp"
+#include "linear.hpp"
+#include "model.hpp"
+#include <Eigen/Dense>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace quantisation {
+typedef Eigen::Matrix<std::int8_t, Eigen::Dynamic, Eigen::Dynamic,
+                      Eigen::RowMajor>
+    MatrixXi8;
+typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+    RowMatrixXf;
+
+#pragma region Quantised linear
+/*
+  Inference only linear layer with symmetric int8 weights and inputs.
+
+  Each output channel of the weight has its own scale. The inputs are quantised
+  with a single scale calibrated on the training data. The int32 accumulators
+  are dequantised, biased and activated in the same pass that produces them.
+*/
+class QuantisedLinear {
+  MatrixXi8 weight;
+  Eigen::VectorXf weightScales, bias;
+  float inputScale;
+  std::string activation;
+
+public:
+  int inChannels, outChannels;
+  QuantisedLinear(MatrixXi8 weight, Eigen::VectorXf weightScales,
+                  Eigen::VectorXf bias, float inputScale,
+                  const std::string &activation = "NoActivation");
+
+  /*
+    Quantise the layer's weight per output channel, using the given scale for
+    the inputs.
+  */
+  static QuantisedLinear quantise(const linear::Linear &layer,
+                                  float inputScale);
+
+#pragma region Properties
+#pragma region Weight
+  /*
+    Get the layer's quantised weight.
+  */
+  MatrixXi8 getWeight() const;
+  /*
+    Get the scale of each output channel of the weight.
+  */
+  Eigen::VectorXf getWeightScales() const;
+#pragma endregion Weight
+
+#pragma region Bias
+  /*
+    Get the layer's bias.
+  */
+  Eigen::VectorXf getBias() const;
+#pragma endregion Bias
+
+#pragma region Input scale
+  /*
+    Get the scale used to quantise the inputs.
+  */
+  float getInputScale() const;
+#pragma endregion Input scale
+
+#pragma region Activation function
+  /*
+    Get the name of the layer's activation function.
+  */
+  std::string getActivation() const;
+#pragma endregion Activation function
+
+#pragma region Size
+  /*
+    The number of bytes used by the layer's parameters.
+  */
+  std::size_t getSize() const;
+#pragma endregion Size
+#pragma endregion Properties
+
+#pragma region Load
+  /*
+    Creates a quantised linear instance from the JSON values. The weights
+    must be integers in [-127, 127].
+  */
+  static QuantisedLinear fromJson(const json &values);
+#pragma endregion Load
+
+#pragma region Save
+  /*
+    Get all relevant attributes in a serialisable format.
+
+    Attributes includes:
+        - weight -- int8 weights as a two-dimensional list
+        - weight_scales -- scale of each output channel as a list
+        - bias -- bias as a list
+        - input_scale -- scale used to quantise the inputs
+        - activation_function -- name of the activation function as a
+                                  string
+  */
+  json toJson() const;
+#pragma endregion Save
+
+#pragma region Forward pass
+  /*
+    Perform the forward pass for the layer.
+  */
+  RowMatrixXf forward(const RowMatrixXf &input) const;
+#pragma endregion Forward pass
+
+#pragma region Builtins
+  bool operator==(const QuantisedLinear &other) const;
+#pragma endregion Builtins
+};
+#pragma endregion Quantised linear
+
+#pragma region Quantised model
+class QuantisedModel {
+  std::vector<QuantisedLinear> layers;
+  std::vector<std::string> classes;
+
+public:
+  QuantisedModel(std::vector<QuantisedLinear> layers,
+                 std::vector<std::string> classes);
+
+  /*
+    Quantise the model, calibrating the input scale of each layer on the first
+    calibrationBatches batches of the given data.
+  */
+  static QuantisedModel
+  quantise(const model::Model &model,
+           const std::shared_ptr<loader::DatasetBatcher> calibrationData,
+           int calibrationBatches);
+
+#pragma region Properties
+#pragma region Layers
+  /*
+    Get a copy of the model's layers.
+  */
+  std::vector<QuantisedLinear> getLayers() const;
+#pragma endregion Layers
+
+#pragma region Classes
+  /*
+    Get the model's classes.
+  */
+  std::vector<std::string> getClasses() const;
+#pragma endregion Classes
+
+#pragma region Size
+  /*
+    The number of bytes used by the model's parameters.
+  */
+  std::size_t getSize() const;
+#pragma endregion Size
+#pragma endregion Properties
+
+#pragma region Load
+  /*
+    Create a quantised model from the JSON values.
+  */
+  static QuantisedModel fromJson(const json &values);
+
+  /*
+    Load the quantised model from the file.
+  */
+  static QuantisedModel load(const std::string &path);
+#pragma endregion Load
+
+#pragma region Save
+  /*
+    Get all relevant attributes in a serialisable format.
+
+    Attributes includes:
+        - layers -- the quantised layers of the model
+        - classes -- the classes of the model
+  */
+  json toJson() const;
+
+  /*
+    Save the quantised model to the given path.
+  */
+  void save(const std::string &path) const;
+#pragma endregion Save
+
+#pragma region Forward pass
+  /*
+    Perform the forward pass.
+  */
+  Eigen::MatrixXd forward(const Eigen::MatrixXd &input) const;
+
+  /*
+    Perform the forward pass and predict the classes for the input.
+  */
+  std::vector<std::string> predict(const Eigen::MatrixXd &input) const;
+#pragma endregion Forward pass
+
+#pragma region Builtins
+  /*
+    Perform the forward pass.
+  */
+  Eigen::MatrixXd operator()(const Eigen::MatrixXd &input) const;
+
+  bool operator==(const QuantisedModel &other) const;
+#pragma endregion Builtins
+};
+#pragma endregion Quantised model
+
+#pragma region Report
+/*
+  Comparison of the quantised model against the model it was quantised from.
+*/
+struct Report {
+  float accuracy = 0, quantisedAccuracy = 0, agreement = 0;
+  double maxLogitError = 0;
+  std::size_t size = 0, quantisedSize = 0;
+};
+
+/*
+  Compare the predictions of the model and its quantised model on the data.
+*/
+Report compare(model::Model &model, const QuantisedModel &quantised,
+               const std::shared_ptr<loader::DatasetBatcher> batcher);
+
+/*
+  Print the comparison report.
+*/
+void printReport(const Report &report);
+#pragma endregion Report
+} // namespace quantisation
\ No newline at end of file
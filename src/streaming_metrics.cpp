@@ -0,0 +1,262 @@
+#include "streaming_metrics.hpp"
+#include "exceptions/metrics.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <typeinfo>
+
+using namespace metrics;
+
+#pragma region Accumulators
+/*
+  Get the other accumulator as the given type, if it accumulates the same
+  metric as the accumulator.
+*/
+template <typename T>
+static const T &asSame(const Accumulator &accumulator,
+                       const Accumulator &other) {
+  if (typeid(accumulator) != typeid(other)) {
+    throw exceptions::metrics::MismatchedAccumulatorException();
+  }
+  return static_cast<const T &>(other);
+}
+
+#pragma region Top k accuracy
+TopKAccuracy::TopKAccuracy(int k) : k(k) {
+  if (k < 1) {
+    throw exceptions::metrics::InvalidTopKException(k);
+  }
+}
+
+void TopKAccuracy::update(const Eigen::MatrixXd &logits,
+                          std::span<const int> actual) {
+  if (logits.rows() != actual.size()) {
+    throw exceptions::metrics::InvalidDatasetException(logits.rows(),
+                                                       actual.size());
+  }
+
+  // The actual class is in the top k if fewer than k classes rank above it,
+  // which avoids sorting each row. Ties rank the lower class first, as the
+  // prediction does, so the top 1 accuracy matches the accuracy
+  for (int i = 0; i < logits.rows(); ++i) {
+    double target = logits(i, actual[i]);
+    int higher = 0;
+    for (int j = 0; j < logits.cols() && higher < this->k; ++j) {
+      higher += logits(i, j) > target ||
+                (logits(i, j) == target && j < actual[i]);
+    }
+    this->correct += higher < this->k;
+  }
+  this->total += logits.rows();
+}
+
+void TopKAccuracy::merge(const Accumulator &other) {
+  const TopKAccuracy &other_ = asSame<TopKAccuracy>(*this, other);
+  if (this->k != other_.k) {
+    throw exceptions::metrics::MismatchedAccumulatorException();
+  }
+  this->correct += other_.correct;
+  this->total += other_.total;
+}
+
+void TopKAccuracy::reset() { this->correct = this->total = 0; }
+
+std::variant<float, std::vector<float>> TopKAccuracy::compute() const {
+  return this->total == 0 ? 0 : (float)this->correct / this->total;
+}
+
+std::unique_ptr<Accumulator> TopKAccuracy::clone() const {
+  return std::make_unique<TopKAccuracy>(*this);
+}
+#pragma endregion Top k accuracy
+
+#pragma region Confidence histogram
+ConfidenceHistogram::ConfidenceHistogram(int bins) {
+  if (bins < 1) {
+    throw exceptions::metrics::InvalidNumberOfBinsException(bins);
+  }
+  this->counts = std::vector<long>(bins);
+  this->correct = std::vector<long>(bins);
+  this->confidences = std::vector<double>(bins);
+}
+
+void ConfidenceHistogram::update(const Eigen::MatrixXd &logits,
+                                 std::span<const int> actual) {
+  if (logits.rows() != actual.size()) {
+    throw exceptions::metrics::InvalidDatasetException(logits.rows(),
+                                                       actual.size());
+  }
+
+  int bins = this->counts.size();
+  for (int i = 0; i < logits.rows(); ++i) {
+    // The softmax probability of the largest logit, shifted for stability
+    int prediction;
+    double max = logits.row(i).maxCoeff(&prediction),
+           confidence = 1 / (logits.row(i).array() - max).exp().sum();
+    int bin = std::min((int)(confidence * bins), bins - 1);
+    ++this->counts[bin];
+    this->correct[bin] += prediction == actual[i];
+    this->confidences[bin] += confidence;
+  }
+}
+
+void ConfidenceHistogram::merge(const Accumulator &other) {
+  const ConfidenceHistogram &other_ =
+      asSame<ConfidenceHistogram>(*this, other);
+  if (this->counts.size() != other_.counts.size()) {
+    throw exceptions::metrics::MismatchedAccumulatorException();
+  }
+  for (int i = 0; i < this->counts.size(); ++i) {
+    this->counts[i] += other_.counts[i];
+    this->correct[i] += other_.correct[i];
+    this->confidences[i] += other_.confidences[i];
+  }
+}
+
+void ConfidenceHistogram::reset() {
+  std::fill(this->counts.begin(), this->counts.end(), 0);
+  std::fill(this->correct.begin(), this->correct.end(), 0);
+  std::fill(this->confidences.begin(), this->confidences.end(), 0);
+}
+
+std::variant<float, std::vector<float>> ConfidenceHistogram::compute() const {
+  long total = 0;
+  for (long count : this->counts) {
+    total += count;
+  }
+  std::vector<float> result(this->counts.size());
+  for (int i = 0; i < this->counts.size(); ++i) {
+    result[i] = total == 0 ? 0 : (float)this->counts[i] / total;
+  }
+  return result;
+}
+
+std::unique_ptr<Accumulator> ConfidenceHistogram::clone() const {
+  return std::make_unique<ConfidenceHistogram>(*this);
+}
+#pragma endregion Confidence histogram
+
+#pragma region Calibration error
+CalibrationError::CalibrationError(int bins) : ConfidenceHistogram(bins){};
+
+std::variant<float, std::vector<float>> CalibrationError::compute() const {
+  long total = 0;
+  for (long count : this->counts) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0.0f;
+  }
+
+  double result = 0;
+  for (int i = 0; i < this->counts.size(); ++i) {
+    result += std::abs(this->correct[i] - this->confidences[i]) / total;
+  }
+  return (float)result;
+}
+
+std::unique_ptr<Accumulator> CalibrationError::clone() const {
+  return std::make_unique<CalibrationError>(*this);
+}
+#pragma endregion Calibration error
+
+std::unique_ptr<Accumulator>
+metrics::makeAccumulator(const std::string &metric) {
+  if (metric == "confidence_histogram") {
+    return std::make_unique<ConfidenceHistogram>(CONFIDENCE_BINS);
+  }
+  if (metric == "calibration_error") {
+    return std::make_unique<CalibrationError>(CONFIDENCE_BINS);
+  }
+
+  std::string prefix = "top_", suffix = "_accuracy";
+  if (metric.size() <= prefix.size() + suffix.size() ||
+      !metric.starts_with(prefix) || !metric.ends_with(suffix)) {
+    return nullptr;
+  }
+  std::string k = metric.substr(
+      prefix.size(), metric.size() - prefix.size() - suffix.size());
+  if (k.size() > 9 || k.front() == '0' ||
+      !std::all_of(k.begin(), k.end(),
+                   [](unsigned char c) { return std::isdigit(c); })) {
+    return nullptr;
+  }
+  return std::make_unique<TopKAccuracy>(std::stoi(k));
+}
+
+bool metrics::isStreamingMetric(const std::string &metric) {
+  return metrics::makeAccumulator(metric) != nullptr;
+}
+
+bool metrics::isSingleValueMetric(const std::string &metric) {
+  if (SINGLE_VALUE_METRICS.contains(metric)) {
+    return true;
+  }
+  std::unique_ptr<Accumulator> accumulator = metrics::makeAccumulator(metric);
+  return accumulator != nullptr &&
+         std::holds_alternative<float>(accumulator->compute());
+}
+#pragma endregion Accumulators
+
+#pragma region Streaming metrics
+StreamingMetrics::StreamingMetrics(const std::vector<std::string> &metrics) {
+  for (const std::string &metric : metrics) {
+    std::unique_ptr<Accumulator> accumulator = metrics::makeAccumulator(metric);
+    if (accumulator != nullptr) {
+      this->accumulators[metric] = std::move(accumulator);
+    }
+  }
+}
+
+StreamingMetrics::StreamingMetrics(const StreamingMetrics &other) {
+  *this = other;
+}
+
+StreamingMetrics &StreamingMetrics::operator=(const StreamingMetrics &other) {
+  if (this == &other) {
+    return *this;
+  }
+  this->accumulators.clear();
+  for (const auto &[metric, accumulator] : other.accumulators) {
+    this->accumulators[metric] = accumulator->clone();
+  }
+  return *this;
+}
+
+bool StreamingMetrics::empty() const { return this->accumulators.empty(); }
+
+bool StreamingMetrics::contains(const std::string &metric) const {
+  return this->accumulators.contains(metric);
+}
+
+void StreamingMetrics::update(const Eigen::MatrixXd &logits,
+                              std::span<const int> actual) {
+  for (auto &[_, accumulator] : this->accumulators) {
+    accumulator->update(logits, actual);
+  }
+}
+
+void StreamingMetrics::merge(const StreamingMetrics &other) {
+  if (this->accumulators.size() != other.accumulators.size()) {
+    throw exceptions::metrics::MismatchedAccumulatorException();
+  }
+  for (auto &[metric, accumulator] : this->accumulators) {
+    if (!other.contains(metric)) {
+      throw exceptions::metrics::MismatchedAccumulatorException();
+    }
+    accumulator->merge(*other.accumulators.at(metric));
+  }
+}
+
+void StreamingMetrics::reset() {
+  for (auto &[_, accumulator] : this->accumulators) {
+    accumulator->reset();
+  }
+}
+
+std::variant<float, std::vector<float>>
+StreamingMetrics::compute(const std::string &metric) const {
+  return this->accumulators.at(metric)->compute();
+}
+#pragma endregion Streaming metrics
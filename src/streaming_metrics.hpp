@@ -0,0 +1,178 @@
+#pragma once
+#include <Eigen/Dense>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace metrics {
+#pragma region Accumulators
+/*
+  Accumulates a metric from the logits and labels of each batch, for metrics
+  that cannot be calculated from the confusion matrix alone.
+*/
+class Accumulator {
+public:
+  virtual ~Accumulator() = default;
+
+  /*
+    Add the logits of the batch and their actual labels.
+  */
+  virtual void update(const Eigen::MatrixXd &logits,
+                      std::span<const int> actual) = 0;
+
+  /*
+    Add the state of the other accumulator of the same metric, such as to
+    merge the accumulators updated separately by each thread.
+  */
+  virtual void merge(const Accumulator &other) = 0;
+
+  /*
+    Clear the accumulated state.
+  */
+  virtual void reset() = 0;
+
+  /*
+    Calculate the metric from the accumulated state.
+  */
+  virtual std::variant<float, std::vector<float>> compute() const = 0;
+
+  /*
+    Get a copy of the accumulator and its state.
+  */
+  virtual std::unique_ptr<Accumulator> clone() const = 0;
+};
+
+/*
+  The share of samples whose actual class is among the k most likely classes.
+*/
+class TopKAccuracy : public Accumulator {
+  int k;
+  long correct = 0, total = 0;
+
+public:
+  TopKAccuracy(int k);
+
+  void update(const Eigen::MatrixXd &logits,
+              std::span<const int> actual) override;
+  void merge(const Accumulator &other) override;
+  void reset() override;
+  std::variant<float, std::vector<float>> compute() const override;
+  std::unique_ptr<Accumulator> clone() const override;
+};
+
+/*
+  The share of samples in each of the equal width bins of the confidence,
+  being the softmax probability of the predicted class.
+*/
+class ConfidenceHistogram : public Accumulator {
+protected:
+  std::vector<long> counts, correct;
+  std::vector<double> confidences;
+
+public:
+  ConfidenceHistogram(int bins);
+
+  void update(const Eigen::MatrixXd &logits,
+              std::span<const int> actual) override;
+  void merge(const Accumulator &other) override;
+  void reset() override;
+  std::variant<float, std::vector<float>> compute() const override;
+  std::unique_ptr<Accumulator> clone() const override;
+};
+
+/*
+  The expected calibration error, being the gap between the accuracy and the
+  mean confidence of each confidence bin, weighted by the share of samples in
+  the bin.
+*/
+class CalibrationError : public ConfidenceHistogram {
+public:
+  CalibrationError(int bins);
+
+  std::variant<float, std::vector<float>> compute() const override;
+  std::unique_ptr<Accumulator> clone() const override;
+};
+
+/*
+  The number of confidence bins of the built-in metrics.
+*/
+const int CONFIDENCE_BINS = 10;
+
+/*
+  Create the accumulator of the streaming metric, or nullptr if the metric is
+  not a streaming metric.
+
+  Streaming metrics:
+          - top_<k>_accuracy -- the top k accuracy for a positive k
+          - confidence_histogram -- the share of samples per confidence bin
+          - calibration_error -- the expected calibration error
+*/
+std::unique_ptr<Accumulator> makeAccumulator(const std::string &metric);
+
+/*
+  Whether the metric is accumulated from the logits.
+*/
+bool isStreamingMetric(const std::string &metric);
+
+/*
+  Whether the metric has a single value per epoch, as opposed to a value per
+  class or per bin.
+*/
+bool isSingleValueMetric(const std::string &metric);
+#pragma endregion Accumulators
+
+#pragma region Streaming metrics
+/*
+  The accumulators of the streaming metrics of a split, updated with the
+  logits of each batch alongside the confusion matrix.
+*/
+class StreamingMetrics {
+  std::map<std::string, std::unique_ptr<Accumulator>> accumulators;
+
+public:
+  StreamingMetrics(){};
+  /*
+    Create the accumulators of the streaming metrics among the given metrics,
+    ignoring the rest.
+  */
+  StreamingMetrics(const std::vector<std::string> &metrics);
+  StreamingMetrics(const StreamingMetrics &other);
+  StreamingMetrics &operator=(const StreamingMetrics &other);
+
+  /*
+    Whether there are no streaming metrics to accumulate.
+  */
+  bool empty() const;
+
+  /*
+    Whether the metric is accumulated.
+  */
+  bool contains(const std::string &metric) const;
+
+  /*
+    Add the logits of the batch and their actual labels to every accumulator.
+  */
+  void update(const Eigen::MatrixXd &logits, std::span<const int> actual);
+
+  /*
+    Add the state of the other streaming metrics, which must track the same
+    metrics.
+  */
+  void merge(const StreamingMetrics &other);
+
+  /*
+    Clear the state of every accumulator.
+  */
+  void reset();
+
+  /*
+    Calculate the metric from its accumulator.
+  */
+  std::variant<float, std::vector<float>>
+  compute(const std::string &metric) const;
+};
+#pragma endregion Streaming metrics
+} // namespace metrics
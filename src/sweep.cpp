@@ -0,0 +1,172 @@
+#include "sweep.hpp"
+#include "cross_entropy_loss.hpp"
+#include "exceptions/sweep.hpp"
+#include "streaming_metrics.hpp"
+#include "utils/string.hpp"
+#include "utils/trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <tabulate/table.hpp>
+#include <thread>
+
+using namespace sweep;
+
+#pragma region Run
+/*
+  Create the untrained model of the trial.
+*/
+static model::Model buildModel(const Trial &trial, int features, int classes,
+                               const RunKeywordArgs &kwargs) {
+  // Each model builds its own layers so no two models share a layer's state
+  std::vector<model::LayerConfig> layers = trial.layers;
+  if (layers.empty()) {
+    layers = model::DEFAULT_HIDDEN_LAYERS;
+    layers.push_back({classes});
+  }
+
+  model::Model::KeywordArgs modelKwargs;
+  modelKwargs.setTrainMetricsFromMetricTypes(kwargs.trainMetrics);
+  modelKwargs.setValidationMetricsFromMetricTypes(kwargs.validationMetrics);
+  return model::Model(model::buildLayers(features, layers, classes),
+                      loss::CrossEntropyLoss(), modelKwargs);
+}
+
+std::vector<Result> sweep::run(const loader::ImageLoader &loader,
+                               const std::vector<Trial> &trials,
+                               const RunKeywordArgs &kwargs) {
+  std::shared_ptr<loader::DatasetBatcher> batcher =
+      loader("train", 1, {.shuffle = false});
+  if (batcher->size() == 0) {
+    throw exceptions::sweep::EmptyDatasetException();
+  }
+  int features = (*batcher)[0].first.cols(),
+      classes = loader.getClasses().size();
+
+  // Build the models up front, as the weights are initialised from a shared
+  // random number generator
+  std::vector<Result> results(trials.size());
+  std::vector<std::unique_ptr<model::Model>> models(trials.size());
+  for (int i = 0; i < trials.size(); ++i) {
+    results[i].name = trials[i].name;
+    try {
+      models[i] = std::make_unique<model::Model>(
+          buildModel(trials[i], features, classes, kwargs));
+    } catch (const std::exception &e) {
+      results[i].error = e.what();
+    }
+  }
+
+  // Each worker takes the next trial, recording its own result
+  std::atomic<int> next = 0;
+  auto work = [&](int worker) {
+    if (worker > 0 && utils::trace::isEnabled()) {
+      utils::trace::setThreadName("Sweep worker " + std::to_string(worker));
+    }
+    for (int i; (i = next.fetch_add(1)) < trials.size();) {
+      const Trial &trial = trials[i];
+      Result &result = results[i];
+      if (models[i] == nullptr) {
+        continue;
+      }
+      model::Model &model = *models[i];
+      auto start = std::chrono::steady_clock::now();
+      try {
+        utils::trace::ScopedEvent event("Trial " + trial.name, "sweep");
+        model::Model::TrainKeywordArgs trainKwargs = trial.kwargs;
+        trainKwargs.verbose = false;
+        model.train(loader, trial.learningRate, trial.batchSize, trial.epochs,
+                    trainKwargs);
+
+        result.epochs = model.getTotalEpochs();
+        for (const auto &[metric, history] : model.getValidationMetrics()) {
+          if (metrics::isSingleValueMetric(metric) && !history.empty()) {
+            result.metrics[metric] = history.back()[0];
+          }
+        }
+      } catch (const std::exception &e) {
+        result.error = e.what();
+      }
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      result.seconds = elapsed.count();
+      models[i].reset();
+    }
+  };
+
+  int workers = std::clamp(kwargs.workers, 1, std::max((int)trials.size(), 1));
+  std::vector<std::thread> threads;
+  for (int worker = 1; worker < workers; ++worker) {
+    threads.emplace_back(work, worker);
+  }
+  work(0);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  return results;
+}
+
+std::vector<Result> sweep::run(const loader::ImageLoader &loader,
+                               const std::vector<Trial> &trials) {
+  return sweep::run(loader, trials, RunKeywordArgs());
+}
+#pragma endregion Run
+
+#pragma region Print
+void sweep::printResults(const std::vector<Result> &results) {
+  int precision = 4;
+  std::set<std::string> metrics;
+  for (const Result &result : results) {
+    for (const auto &[metric, _] : result.metrics) {
+      metrics.insert(metric);
+    }
+  }
+
+  tabulate::Table table;
+  tabulate::Table::Row_t header{"Trial", "Epochs"};
+  for (const std::string &metric : metrics) {
+    header.push_back(utils::string::capitalise(
+        utils::string::join(utils::string::split(metric, "_"), " ")));
+  }
+  header.push_back("Time (s)");
+  table.add_row(header);
+  for (const Result &result : results) {
+    tabulate::Table::Row_t row{result.name, std::to_string(result.epochs)};
+    for (const std::string &metric : metrics) {
+      row.push_back(result.metrics.contains(metric)
+                        ? utils::string::floatToString(
+                              result.metrics.at(metric), precision)
+                        : "-");
+    }
+    row.push_back(utils::string::floatToString(result.seconds, 2));
+    table.add_row(row);
+  }
+
+  // Style table
+  table.format()
+      .border(" ")
+      .corner(" ")
+      .font_align(tabulate::FontAlign::right)
+      .hide_border_top()
+      .hide_border_bottom();
+  table.row(0)
+      .format()
+      .font_style({tabulate::FontStyle::bold})
+      .font_align(tabulate::FontAlign::center)
+      .show_border_top();
+  if (results.size() > 0) {
+    table.row(1).format().border_top("-").show_border_top();
+  }
+  table.column(0).format().font_align(tabulate::FontAlign::left);
+
+  std::cout << table << std::endl;
+  for (const Result &result : results) {
+    if (!result.error.empty()) {
+      std::cout << result.name << " failed: " << result.error << std::endl;
+    }
+  }
+}
+#pragma endregion Print
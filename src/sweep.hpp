@@ -0,0 +1,65 @@
+#pragma once
+#include "image_loader.hpp"
+#include "model.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sweep {
+/*
+  The hyperparameters of a model trained in a sweep.
+
+  The model's layers end with the output layer, whose size must match the
+  classes of the dataset, and the first layer takes the dataset's features.
+  Without layers, the model has the default hidden layers followed by an
+  output layer per class.
+*/
+struct Trial {
+  std::string name;
+  double learningRate = 1e-4;
+  int batchSize = 1;
+  int epochs = 1;
+  std::vector<model::LayerConfig> layers;
+  model::Model::TrainKeywordArgs kwargs;
+};
+
+/*
+  The outcome of a trial, being its final validation metrics, or the error
+  that stopped it.
+*/
+struct Result {
+  std::string name;
+  std::map<std::string, float> metrics;
+  int epochs = 0;
+  double seconds = 0;
+  std::string error;
+};
+
+struct RunKeywordArgs {
+  int workers = 1;
+  std::vector<std::string> trainMetrics{"loss"},
+      validationMetrics{"loss", "accuracy"};
+};
+
+/*
+  Train a model per trial on the loader, returning the results in the order
+  of the trials.
+
+  The trials are shared between the given number of workers, each training one
+  model at a time. Every model reads the same loader, so the loader should
+  hold the decoded dataset in memory to avoid decoding it once per model. The
+  models are trained without printing or drawing progress bars, and a trial
+  that throws only fails that trial.
+*/
+std::vector<Result> run(const loader::ImageLoader &loader,
+                        const std::vector<Trial> &trials,
+                        const RunKeywordArgs &kwargs);
+std::vector<Result> run(const loader::ImageLoader &loader,
+                        const std::vector<Trial> &trials);
+
+/*
+  Print the results as a table comparing the single value metrics and wall
+  time of each trial.
+*/
+void printResults(const std::vector<Result> &results);
+} // namespace sweep
@@ -0,0 +1,128 @@
+#include "allocations.hpp"
+#include "memory.hpp"
+#include "string.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <tabulate/table.hpp>
+
+using namespace utils::allocations;
+
+#pragma region Hook
+static thread_local std::size_t allocationCount = 0, allocatedBytes = 0;
+
+#if defined(COUNT_ALLOCATIONS) && defined(__GLIBC__)
+/*
+  Replace glibc's allocation functions with ones that count the allocations
+  before forwarding them to glibc's implementation. Memory allocated by
+  operator new and Eigen both pass through malloc.
+*/
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(std::size_t size) noexcept {
+  ++allocationCount;
+  allocatedBytes += size;
+  return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size) noexcept {
+  ++allocationCount;
+  allocatedBytes += count * size;
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, std::size_t size) noexcept {
+  ++allocationCount;
+  allocatedBytes += size;
+  return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) noexcept { __libc_free(ptr); }
+}
+
+bool utils::allocations::isEnabled() { return true; }
+#else
+bool utils::allocations::isEnabled() { return false; }
+#endif
+
+Counts utils::allocations::getCounts() {
+  return {allocationCount, allocatedBytes};
+}
+#pragma endregion Hook
+
+#pragma region Scoped counter
+ScopedCounter::ScopedCounter() : start(utils::allocations::getCounts()) {}
+
+Counts ScopedCounter::get() const {
+  Counts counts = utils::allocations::getCounts();
+  return {counts.allocations - this->start.allocations,
+          counts.bytes - this->start.bytes};
+}
+#pragma endregion Scoped counter
+
+#pragma region Allocation tracker
+void AllocationTracker::record(const std::string &stage, const Counts &counts) {
+  auto it = this->indices.find(stage);
+  if (it == this->indices.end()) {
+    it = this->indices.emplace(stage, this->stages.size()).first;
+    this->stages.push_back({stage});
+  }
+  Stage &result = this->stages[it->second];
+  ++result.batches;
+  result.allocations += counts.allocations;
+  result.bytes += counts.bytes;
+  result.maxAllocations = std::max(result.maxAllocations, counts.allocations);
+}
+
+const std::vector<Stage> &AllocationTracker::getStages() const {
+  return this->stages;
+}
+
+void AllocationTracker::clear() {
+  this->stages.clear();
+  this->indices.clear();
+}
+#pragma endregion Allocation tracker
+
+#pragma region Print
+void utils::allocations::printAllocations(const AllocationTracker &tracker) {
+  if (tracker.getStages().empty()) {
+    return;
+  }
+
+  tabulate::Table table;
+
+  // Add rows
+  table.add_row({"Stage", "Allocations per batch", "Most allocations",
+                 "Bytes per batch"});
+  for (const Stage &stage : tracker.getStages()) {
+    table.add_row(
+        {stage.stage,
+         utils::string::floatToString((double)stage.allocations / stage.batches,
+                                      2),
+         std::to_string(stage.maxAllocations),
+         utils::memory::formatBytes(stage.bytes / stage.batches)});
+  }
+
+  // Style table
+  table.format()
+      .border(" ")
+      .corner(" ")
+      .font_align(tabulate::FontAlign::right)
+      .hide_border_top()
+      .hide_border_bottom();
+  table.column(0).format().font_align(tabulate::FontAlign::left);
+  table.row(0)
+      .format()
+      .font_style({tabulate::FontStyle::bold})
+      .font_align(tabulate::FontAlign::center)
+      .show_border_top();
+  table.row(1).format().border_top("-").show_border_top();
+
+  std::cout << table << std::endl;
+}
+#pragma endregion Print
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+  Counts the heap allocations made by each thread.
+
+  Allocations are only counted when built with COUNT_ALLOCATIONS against glibc,
+  which interposes malloc to count every allocation, including Eigen's.
+*/
+namespace utils::allocations {
+/*
+  The number of allocations made and the bytes requested by them.
+*/
+struct Counts {
+  std::size_t allocations = 0, bytes = 0;
+};
+
+/*
+  Whether allocations are being counted.
+*/
+bool isEnabled();
+
+/*
+  Get the allocations made by the calling thread so far.
+*/
+Counts getCounts();
+
+/*
+  Counts the allocations made by the calling thread during its lifetime.
+*/
+class ScopedCounter {
+  Counts start;
+
+public:
+  ScopedCounter();
+
+  /*
+    Get the allocations made since the counter was created.
+  */
+  Counts get() const;
+};
+
+/*
+  The allocations of a stage across the batches it ran for.
+*/
+struct Stage {
+  std::string stage;
+  std::size_t batches = 0, allocations = 0, bytes = 0, maxAllocations = 0;
+};
+
+/*
+  Accumulates the allocations made by each stage per batch, keeping the stages
+  in the order they were first recorded.
+*/
+class AllocationTracker {
+  std::vector<Stage> stages;
+  std::unordered_map<std::string, int> indices;
+
+public:
+  /*
+    Add the allocations of one batch of the stage.
+  */
+  void record(const std::string &stage, const Counts &counts);
+
+  /*
+    Get the allocations of each stage.
+  */
+  const std::vector<Stage> &getStages() const;
+
+  /*
+    Remove all the stages.
+  */
+  void clear();
+};
+
+/*
+  Print the mean and most allocations per batch of each stage, and the mean
+  bytes requested per batch.
+*/
+void printAllocations(const AllocationTracker &tracker);
+} // namespace utils::allocations
\ No newline at end of file
@@ -1,11 +1,83 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <indicators/progress_bar.hpp>
 #include <indicators/setting.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 
 using namespace indicators;
 namespace utils::indicators {
 /*
   Get a default progress bar.
 */
-ProgressBar getDefaultProgressBar();
+std::unique_ptr<ProgressBar> getDefaultProgressBar();
+
+/*
+  Enable or disable the progress bars.
+*/
+void setEnabled(bool enabled);
+
+/*
+  Whether progress bars are hidden, either because they were disabled or
+  because the output is not a terminal.
+*/
+bool isSilent();
+
+/*
+  Reports the progress of a loop on a progress bar.
+
+  Ticking only increments an atomic counter. The bar is redrawn from a
+  background thread at most once per refresh interval, keeping the bar's lock
+  and the terminal writes out of the loop. Nothing is drawn when silent or not
+  visible, such as when several loops run at once.
+*/
+class ProgressReporter {
+  int total;
+  std::atomic<int> progress;
+  std::unique_ptr<ProgressBar> bar;
+  std::thread worker;
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool stopping = false;
+
+  /*
+    Redraw the bar until finished.
+  */
+  void run();
+
+  /*
+    Draw the bar at the given progress.
+  */
+  void draw(int progress);
+
+public:
+  static const std::chrono::milliseconds REFRESH_INTERVAL;
+
+  ProgressReporter(const std::string &description, int total, int start = 0,
+                   bool visible = true);
+  ~ProgressReporter();
+
+  ProgressReporter(const ProgressReporter &) = delete;
+  ProgressReporter &operator=(const ProgressReporter &) = delete;
+
+  /*
+    Mark one more step as done.
+  */
+  void tick() { this->progress.fetch_add(1, std::memory_order_relaxed); }
+
+  /*
+    Get the number of steps done.
+  */
+  int getProgress() const;
+
+  /*
+    Stop redrawing and draw the final progress. Called on destruction if not
+    called before.
+  */
+  void finish();
+};
 } // namespace utils::indicators
\ No newline at end of file
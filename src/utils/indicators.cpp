@@ -1,14 +1,96 @@
 #include "indicator.hpp"
+#include <cstdio>
+#include <indicators/cursor_control.hpp>
+#include <unistd.h>
 
-ProgressBar utils::indicators::getDefaultProgressBar() {
-  return ProgressBar{option::BarWidth{50},
-                     option::Start{"["},
-                     option::Fill{"█"},
-                     option::Lead{"█"},
-                     option::Remainder{"-"},
-                     option::End{"]"},
-                     option::ForegroundColor{Color::white},
-                     option::ShowElapsedTime{true},
-                     option::ShowRemainingTime{true},
-                     option::ShowPercentage{true}};
-}
\ No newline at end of file
+using namespace utils::indicators;
+
+std::unique_ptr<ProgressBar> utils::indicators::getDefaultProgressBar() {
+  return std::unique_ptr<ProgressBar>(
+      new ProgressBar{option::BarWidth{50},
+                      option::Start{"["},
+                      option::Fill{"█"},
+                      option::Lead{"█"},
+                      option::Remainder{"-"},
+                      option::End{"]"},
+                      option::ForegroundColor{Color::white},
+                      option::ShowElapsedTime{true},
+                      option::ShowRemainingTime{true},
+                      option::ShowPercentage{true}});
+}
+
+#pragma region Silent mode
+static std::atomic<bool> progressBarsEnabled = true;
+
+void utils::indicators::setEnabled(bool enabled) {
+  progressBarsEnabled = enabled;
+}
+
+bool utils::indicators::isSilent() {
+  return !progressBarsEnabled || !isatty(fileno(stdout));
+}
+#pragma endregion Silent mode
+
+#pragma region Progress reporter
+const std::chrono::milliseconds ProgressReporter::REFRESH_INTERVAL{100};
+
+ProgressReporter::ProgressReporter(const std::string &description, int total,
+                                   int start, bool visible)
+    : total(total), progress(start) {
+  if (!visible || utils::indicators::isSilent() || total <= 0) {
+    return;
+  }
+
+  ::indicators::show_console_cursor(false);
+  this->bar = utils::indicators::getDefaultProgressBar();
+  this->bar->set_option(option::PrefixText{description});
+  this->bar->set_option(option::MaxProgress{total});
+  this->draw(start);
+  this->worker = std::thread(&ProgressReporter::run, this);
+}
+
+ProgressReporter::~ProgressReporter() { this->finish(); }
+
+int ProgressReporter::getProgress() const {
+  return this->progress.load(std::memory_order_relaxed);
+}
+
+void ProgressReporter::run() {
+  int drawn = this->getProgress();
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (!this->condition.wait_for(lock, REFRESH_INTERVAL,
+                                   [this] { return this->stopping; })) {
+    int current = this->getProgress();
+    if (current != drawn && current < this->total) {
+      this->draw(current);
+      drawn = current;
+    }
+  }
+}
+
+void ProgressReporter::draw(int progress) {
+  this->bar->set_option(option::PostfixText{std::to_string(progress) + "/" +
+                                            std::to_string(this->total)});
+  this->bar->set_progress(progress);
+}
+
+void ProgressReporter::finish() {
+  if (this->bar == nullptr) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopping = true;
+  }
+  this->condition.notify_one();
+  this->worker.join();
+
+  this->draw(this->getProgress());
+  if (!this->bar->is_completed()) {
+    this->bar->mark_as_completed();
+  }
+  this->bar.reset();
+  ::indicators::show_console_cursor(true);
+}
+#pragma endregion Progress reporter
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "math.hpp"
 #include "../exceptions/utils.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
 
 Eigen::MatrixXi utils::math::oneHotEncode(const std::vector<int> &targets,
                                           int numClasses) {
@@ -39,3 +42,40 @@ utils::math::logitsToPrediction(const Eigen::MatrixXd &logits) {
   }
   return indices;
 }
+
+std::vector<int> utils::math::stratifiedSample(const std::vector<int> &labels,
+                                               int samples, unsigned int seed) {
+  samples = std::clamp(samples, 0, (int)labels.size());
+  std::map<int, std::vector<int>> groups;
+  for (int i = 0; i < labels.size(); ++i) {
+    groups[labels[i]].push_back(i);
+  }
+
+  // Give each label its share of the sample rounded down, then give the
+  // remaining samples to the labels with the largest remainders
+  std::vector<std::pair<double, int>> remainders;
+  std::map<int, int> quotas;
+  int allocated = 0;
+  for (const auto &[label, indices] : groups) {
+    double share = (double)samples * indices.size() / labels.size();
+    quotas[label] = share;
+    allocated += quotas[label];
+    remainders.push_back({share - quotas[label], label});
+  }
+  std::stable_sort(
+      remainders.begin(), remainders.end(),
+      [](const auto &a, const auto &b) { return a.first > b.first; });
+  for (int i = 0; i < samples - allocated; ++i) {
+    ++quotas[remainders[i].second];
+  }
+
+  std::default_random_engine engine{seed};
+  std::vector<int> result;
+  for (auto &[label, indices] : groups) {
+    std::shuffle(indices.begin(), indices.end(), engine);
+    result.insert(result.end(), indices.begin(),
+                  indices.begin() + quotas[label]);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
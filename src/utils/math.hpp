@@ -45,4 +45,12 @@ Eigen::MatrixXd normalise(const Eigen::MatrixXd &data,
   Converts logits to its prediction.
 */
 std::vector<int> logitsToPrediction(const Eigen::MatrixXd &logits);
+
+/*
+  Get the indices of a stratified sample of the labels, keeping the share of
+  each label. The sample is drawn with the given seed and the indices are in
+  ascending order.
+*/
+std::vector<int> stratifiedSample(const std::vector<int> &labels, int samples,
+                                  unsigned int seed);
 } // namespace utils::math
\ No newline at end of file
@@ -32,6 +32,25 @@ Eigen::MatrixXd utils::matrix::fromJson(const json &values) {
   return result;
 }
 
+Eigen::VectorXd utils::matrix::vectorFromJson(const json &values) {
+  if (!values.is_array()) {
+    throw exceptions::json::JSONTypeException();
+  }
+
+  Eigen::VectorXd result(values.size());
+  for (int i = 0; i < values.size(); ++i) {
+    if (values[i].is_array()) {
+      throw exceptions::json::JSONArray1DException();
+    }
+    if (!values[i].is_number()) {
+      throw exceptions::json::JSONTypeException();
+    }
+    result(i) = values[i];
+  }
+
+  return result;
+}
+
 Eigen::MatrixXd utils::matrix::flatten(const Eigen::MatrixXd &in) {
   Eigen::MatrixXd out(in);
   return out.reshaped<Eigen::RowMajor>().transpose();
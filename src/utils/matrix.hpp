@@ -30,6 +30,10 @@ template <typename T> json toJson(const Eigen::MatrixBase<T> &matrix) {
   Convert a nested json array to a matrix.
 */
 Eigen::MatrixXd fromJson(const json &values);
+/*
+  Convert a flat json array to a column vector.
+*/
+Eigen::VectorXd vectorFromJson(const json &values);
 /*
   Flatten the matrix to be 1xN matrix.
 */
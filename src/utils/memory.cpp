@@ -0,0 +1,91 @@
+#include "memory.hpp"
+#include "string.hpp"
+#include <algorithm>
+#include <iostream>
+#include <tabulate/table.hpp>
+#include <utility>
+
+using namespace utils::memory;
+
+std::string utils::memory::formatBytes(std::size_t bytes) {
+  static const std::vector<std::pair<std::string, double>> units{
+      {"GiB", 1 << 30}, {"MiB", 1 << 20}, {"KiB", 1 << 10}};
+  for (const auto &[unit, scale] : units) {
+    if (bytes >= scale) {
+      return utils::string::floatToString(bytes / scale, 2) + " " + unit;
+    }
+  }
+  return std::to_string(bytes) + " B";
+}
+
+#pragma region Usage
+std::size_t Usage::getSteadyState() const {
+  return this->samples == 0 ? 0 : this->total / this->samples;
+}
+#pragma endregion Usage
+
+#pragma region Memory tracker
+void MemoryTracker::record(const std::string &component, std::size_t bytes) {
+  auto it = this->indices.find(component);
+  if (it == this->indices.end()) {
+    it = this->indices.emplace(component, this->usages.size()).first;
+    this->usages.push_back({component});
+  }
+  Usage &usage = this->usages[it->second];
+  usage.current = bytes;
+  usage.peak = std::max(usage.peak, bytes);
+  usage.total += bytes;
+  ++usage.samples;
+}
+
+const std::vector<Usage> &MemoryTracker::getUsages() const {
+  return this->usages;
+}
+
+void MemoryTracker::clear() {
+  this->usages.clear();
+  this->indices.clear();
+}
+#pragma endregion Memory tracker
+
+#pragma region Print
+void utils::memory::printMemory(const MemoryTracker &tracker) {
+  if (tracker.getUsages().empty()) {
+    return;
+  }
+
+  tabulate::Table table;
+  std::size_t steadyState = 0, peak = 0;
+
+  // Add rows
+  table.add_row({"Component", "Steady state", "Peak"});
+  for (const Usage &usage : tracker.getUsages()) {
+    table.add_row({usage.component, formatBytes(usage.getSteadyState()),
+                   formatBytes(usage.peak)});
+    steadyState += usage.getSteadyState();
+    peak += usage.peak;
+  }
+  table.add_row({"Total", formatBytes(steadyState), formatBytes(peak)});
+
+  // Style table
+  table.format()
+      .border(" ")
+      .corner(" ")
+      .font_align(tabulate::FontAlign::right)
+      .hide_border_top()
+      .hide_border_bottom();
+  table.column(0).format().font_align(tabulate::FontAlign::left);
+  table.row(0)
+      .format()
+      .font_style({tabulate::FontStyle::bold})
+      .font_align(tabulate::FontAlign::center)
+      .show_border_top();
+  table.row(1).format().border_top("-").show_border_top();
+  table.row(tracker.getUsages().size() + 1)
+      .format()
+      .border_top("-")
+      .show_border_top();
+
+  std::cout << table << std::endl;
+}
+#pragma endregion Print
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include <Eigen/Dense>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace utils::memory {
+/*
+  Get the number of bytes held by the matrix's coefficients.
+*/
+template <typename Derived>
+std::size_t getSize(const Eigen::DenseBase<Derived> &matrix) {
+  return matrix.size() * sizeof(typename Derived::Scalar);
+}
+
+/*
+  Get the number of bytes held by the matrix's coefficients, or 0 if there is
+  no matrix.
+*/
+template <typename T> std::size_t getSize(const std::shared_ptr<T> &matrix) {
+  return matrix == nullptr ? 0 : utils::memory::getSize(*matrix);
+}
+
+/*
+  Format the bytes in the largest binary unit it has at least one of.
+*/
+std::string formatBytes(std::size_t bytes);
+
+/*
+  The bytes held by a component, across the samples taken of it.
+*/
+struct Usage {
+  std::string component;
+  std::size_t current = 0, peak = 0, total = 0;
+  int samples = 0;
+
+  /*
+    Get the mean of the samples, the usage the component settles at.
+  */
+  std::size_t getSteadyState() const;
+};
+
+/*
+  Samples the bytes held by each component, keeping the components in the order
+  they were first sampled.
+*/
+class MemoryTracker {
+  std::vector<Usage> usages;
+  std::unordered_map<std::string, int> indices;
+
+public:
+  /*
+    Sample the bytes currently held by the component.
+  */
+  void record(const std::string &component, std::size_t bytes);
+
+  /*
+    Get the usage of each component.
+  */
+  const std::vector<Usage> &getUsages() const;
+
+  /*
+    Remove all the samples.
+  */
+  void clear();
+};
+
+/*
+  Print the steady state and peak usage of each component.
+*/
+void printMemory(const MemoryTracker &tracker);
+} // namespace utils::memory
\ No newline at end of file
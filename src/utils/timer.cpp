@@ -0,0 +1,98 @@
+#include "timer.hpp"
+#include "string.hpp"
+#include <chrono>
+#include <iostream>
+#include <tabulate/table.hpp>
+
+using namespace utils::timer;
+
+#pragma region Stage timer
+void StageTimer::add(const std::string &stage, double seconds) {
+  auto it = this->indices.find(stage);
+  if (it == this->indices.end()) {
+    it = this->indices.emplace(stage, this->timings.size()).first;
+    this->timings.push_back({stage});
+  }
+  Timing &timing = this->timings[it->second];
+  timing.seconds += seconds;
+  ++timing.calls;
+}
+
+const std::vector<Timing> &StageTimer::getTimings() const {
+  return this->timings;
+}
+
+double StageTimer::getTotalSeconds() const {
+  double total = 0;
+  for (const Timing &timing : this->timings) {
+    total += timing.seconds;
+  }
+  return total;
+}
+
+void StageTimer::clear() {
+  this->timings.clear();
+  this->indices.clear();
+}
+#pragma endregion Stage timer
+
+#pragma region Scoped timer
+ScopedTimer::ScopedTimer(StageTimer *timer, const char *stage,
+                         const char *category, int index)
+    : timer(timer), event(stage, category, index) {
+  if (this->timer != nullptr) {
+    this->stage = utils::trace::getIndexedName(stage, index);
+    this->start = std::chrono::steady_clock::now();
+  }
+}
+
+ScopedTimer::~ScopedTimer() {
+  if (this->timer != nullptr) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - this->start;
+    this->timer->add(this->stage, elapsed.count());
+  }
+}
+#pragma endregion Scoped timer
+
+#pragma region Print
+void utils::timer::printTimings(const StageTimer &timer) {
+  if (timer.getTimings().empty()) {
+    return;
+  }
+
+  tabulate::Table table;
+  int precision = 4;
+  double total = timer.getTotalSeconds();
+
+  // Add rows
+  table.add_row({"Stage", "Total (s)", "Mean (ms)", "Calls", "Share"});
+  for (const Timing &timing : timer.getTimings()) {
+    table.add_row(
+        {timing.stage, utils::string::floatToString(timing.seconds, precision),
+         utils::string::floatToString(timing.seconds * 1000 / timing.calls,
+                                      precision),
+         std::to_string(timing.calls),
+         utils::string::floatToString(
+             total > 0 ? timing.seconds / total * 100 : 0, 2) +
+             "%"});
+  }
+
+  // Style table
+  table.format()
+      .border(" ")
+      .corner(" ")
+      .font_align(tabulate::FontAlign::right)
+      .hide_border_top()
+      .hide_border_bottom();
+  table.column(0).format().font_align(tabulate::FontAlign::left);
+  table.row(0)
+      .format()
+      .font_style({tabulate::FontStyle::bold})
+      .font_align(tabulate::FontAlign::center)
+      .show_border_top();
+  table.row(1).format().border_top("-").show_border_top();
+
+  std::cout << table << std::endl;
+}
+#pragma endregion Print
\ No newline at end of file
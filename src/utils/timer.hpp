@@ -0,0 +1,76 @@
+#pragma once
+#include "trace.hpp"
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace utils::timer {
+/*
+  The total time spent in a stage and the number of times it was timed.
+*/
+struct Timing {
+  std::string stage;
+  double seconds = 0;
+  int calls = 0;
+};
+
+/*
+  Accumulates the time spent in each stage, keeping the stages in the order
+  they were first timed.
+*/
+class StageTimer {
+  std::vector<Timing> timings;
+  std::unordered_map<std::string, int> indices;
+
+public:
+  /*
+    Add the duration to the stage's total.
+  */
+  void add(const std::string &stage, double seconds);
+
+  /*
+    Get the timings of each stage.
+  */
+  const std::vector<Timing> &getTimings() const;
+
+  /*
+    Get the total time spent across all stages.
+  */
+  double getTotalSeconds() const;
+
+  /*
+    Remove all the timings.
+  */
+  void clear();
+};
+
+/*
+  Times its lifetime, adding it to the stage of the timer when destroyed. The
+  stage is also recorded as a trace event with the given category while
+  tracing.
+
+  Does nothing when the timer is a nullptr and tracing is disabled, so timing
+  can be disabled without reading the clock or building the stage's name. The
+  stage is named by the name followed by the index, if positive.
+*/
+class ScopedTimer {
+  StageTimer *timer;
+  utils::trace::ScopedEvent event;
+  std::string stage;
+  std::chrono::steady_clock::time_point start;
+
+public:
+  ScopedTimer(StageTimer *timer, const char *stage,
+              const char *category = "stage", int index = 0);
+  ~ScopedTimer();
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+};
+
+/*
+  Print the total and mean time of each stage, and its share of the total time.
+*/
+void printTimings(const StageTimer &timer);
+} // namespace utils::timer
\ No newline at end of file
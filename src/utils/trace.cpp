@@ -0,0 +1,165 @@
+#include "trace.hpp"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace utils::trace;
+
+#pragma region Buffers
+/*
+  An event relative to the start of the trace, in microseconds.
+*/
+struct Event {
+  std::string name, category;
+  double start, duration;
+};
+
+/*
+  The events recorded by a single thread.
+*/
+struct ThreadBuffer {
+  int id;
+  std::string name;
+  std::mutex mutex;
+  std::vector<Event> events;
+};
+
+static std::atomic<bool> enabled = false;
+static std::atomic<std::chrono::steady_clock::rep> origin =
+    std::chrono::steady_clock::now().time_since_epoch().count();
+static std::mutex buffersMutex;
+static std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+/*
+  Get the calling thread's buffer, registering it on first use.
+*/
+static ThreadBuffer &getThreadBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+    auto buffer = std::make_shared<ThreadBuffer>();
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffer->id = buffers.size() + 1;
+    buffer->name = "Thread " + std::to_string(buffer->id);
+    buffers.push_back(buffer);
+    return buffer;
+  }();
+  return *buffer;
+}
+
+/*
+  Get the microseconds between the start of the trace and the time.
+*/
+static double toMicroseconds(std::chrono::steady_clock::time_point time) {
+  std::chrono::steady_clock::duration elapsed =
+      time.time_since_epoch() -
+      std::chrono::steady_clock::duration(origin.load());
+  return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+#pragma endregion Buffers
+
+#pragma region Recording
+void utils::trace::start() {
+  {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer : buffers) {
+      std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+      buffer->events.clear();
+    }
+  }
+  origin = std::chrono::steady_clock::now().time_since_epoch().count();
+  utils::trace::setThreadName("Main");
+  enabled = true;
+}
+
+void utils::trace::stop() { enabled = false; }
+
+bool utils::trace::isEnabled() { return enabled; }
+
+void utils::trace::setThreadName(const std::string &name) {
+  ThreadBuffer &buffer = getThreadBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.name = name;
+}
+
+void utils::trace::record(const std::string &name, const std::string &category,
+                          std::chrono::steady_clock::time_point start,
+                          std::chrono::steady_clock::time_point end) {
+  if (!enabled) {
+    return;
+  }
+  double startTime = toMicroseconds(start);
+  Event event{name, category, startTime, toMicroseconds(end) - startTime};
+  ThreadBuffer &buffer = getThreadBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.events.push_back(std::move(event));
+}
+#pragma endregion Recording
+
+#pragma region Save
+json utils::trace::toJson() {
+  json events = json::array();
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  for (const std::shared_ptr<ThreadBuffer> &buffer : buffers) {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    events.push_back({{"name", "thread_name"},
+                      {"ph", "M"},
+                      {"pid", 1},
+                      {"tid", buffer->id},
+                      {"args", {{"name", buffer->name}}}});
+    for (const Event &event : buffer->events) {
+      events.push_back({{"name", event.name},
+                        {"cat", event.category},
+                        {"ph", "X"},
+                        {"ts", event.start},
+                        {"dur", event.duration},
+                        {"pid", 1},
+                        {"tid", buffer->id}});
+    }
+  }
+  return {{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+}
+
+void utils::trace::save(const std::string &path) {
+  std::filesystem::path savePath(path);
+  if (savePath.has_parent_path()) {
+    std::filesystem::create_directories(savePath.parent_path());
+  }
+  std::ofstream file(savePath);
+  file << utils::trace::toJson().dump();
+  file.close();
+}
+#pragma endregion Save
+
+#pragma region Scoped event
+std::string utils::trace::getIndexedName(const char *name, int index) {
+  return index > 0 ? name + (" " + std::to_string(index)) : name;
+}
+
+ScopedEvent::ScopedEvent(const char *name, const char *category, int index)
+    : enabled(utils::trace::isEnabled()), category(category) {
+  if (this->enabled) {
+    this->name = utils::trace::getIndexedName(name, index);
+    this->start = std::chrono::steady_clock::now();
+  }
+}
+
+ScopedEvent::ScopedEvent(const std::string &name, const char *category)
+    : enabled(utils::trace::isEnabled()), category(category) {
+  if (this->enabled) {
+    this->name = name;
+    this->start = std::chrono::steady_clock::now();
+  }
+}
+
+ScopedEvent::~ScopedEvent() {
+  if (this->enabled) {
+    utils::trace::record(this->name, this->category, this->start,
+                         std::chrono::steady_clock::now());
+  }
+}
+#pragma endregion Scoped event
\ No newline at end of file
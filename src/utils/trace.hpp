@@ -0,0 +1,84 @@
+#pragma once
+#include <chrono>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+
+using json = nlohmann::json;
+
+/*
+  Records a timeline of events across all threads, in the Chrome trace event
+  format loadable by chrome://tracing and Perfetto.
+
+  Each thread records into its own buffer, so events are only contended when
+  the trace is being exported. Events are not recorded while tracing is
+  stopped.
+*/
+namespace utils::trace {
+/*
+  Clear any recorded events and start recording, naming the calling thread
+  "Main".
+*/
+void start();
+
+/*
+  Stop recording events, keeping the events that were recorded.
+*/
+void stop();
+
+/*
+  Whether events are being recorded.
+*/
+bool isEnabled();
+
+/*
+  Name the calling thread in the trace.
+*/
+void setThreadName(const std::string &name);
+
+/*
+  Record an event that ran on the calling thread.
+*/
+void record(const std::string &name, const std::string &category,
+            std::chrono::steady_clock::time_point start,
+            std::chrono::steady_clock::time_point end);
+
+/*
+  Get the recorded events in the Chrome trace event format.
+*/
+json toJson();
+
+/*
+  Save the recorded events to the given path.
+*/
+void save(const std::string &path);
+
+/*
+  Get the name followed by the index, or only the name if the index is not
+  positive, such as "Forward layer 1".
+*/
+std::string getIndexedName(const char *name, int index);
+
+/*
+  Records its lifetime as an event when destroyed.
+
+  Does nothing when tracing was disabled on construction. The name is only
+  built while tracing, so an event costs no allocations otherwise.
+*/
+class ScopedEvent {
+  bool enabled;
+  std::string name;
+  const char *category;
+  std::chrono::steady_clock::time_point start;
+
+public:
+  /*
+    Record the event named by the name followed by the index, if positive.
+  */
+  ScopedEvent(const char *name, const char *category, int index = 0);
+  ScopedEvent(const std::string &name, const char *category);
+  ~ScopedEvent();
+
+  ScopedEvent(const ScopedEvent &) = delete;
+  ScopedEvent &operator=(const ScopedEvent &) = delete;
+};
+} // namespace utils::trace
\ No newline at end of file
@@ -85,6 +85,19 @@ TEST_P(TestActivationFunctions, TestForward) {
       << "Operation was done inplace but should not have been.";
 }
 
+TEST_P(TestActivationFunctions, TestInfer) {
+  std::shared_ptr<ActivationFunction> function =
+      getActivationFunction(GetParam().type);
+  auto [X, Y, _] = getData(GetParam().type);
+  ASSERT_TRUE(function->infer(X).isApprox(Y)) << "Infer:\n"
+                                               << typeid(function).name()
+                                               << "\n"
+                                               << X << "\n"
+                                               << Y << "\n";
+  EXPECT_EQ(0, function->getCacheSize())
+      << "Infer saved the input for the backward pass.";
+}
+
 TEST_P(TestActivationFunctions, TestBackward) {
   std::shared_ptr<ActivationFunction> function =
       getActivationFunction(GetParam().type);
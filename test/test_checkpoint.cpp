@@ -0,0 +1,159 @@
+#include "checkpoint.hpp"
+#include "cross_entropy_loss.hpp"
+#include "exceptions/checkpoint.hpp"
+#include "exceptions/model.hpp"
+#include "fixtures.hpp"
+#include "linear.hpp"
+#include "model.hpp"
+#include <Eigen/Dense>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+using namespace checkpoint;
+using json = nlohmann::json;
+
+namespace test_checkpoint {
+#pragma region Fixtures
+model::Model getModel() {
+  std::vector<linear::Linear> layers{linear::Linear(4, 3, "ReLU"),
+                                     linear::Linear(3, 2)};
+  model::Model::KeywordArgs kwargs;
+  kwargs.setTrainMetricsFromMetricTypes({"loss"});
+  kwargs.classes = {"0", "1"};
+  kwargs.totalEpochs = 4;
+  return model::Model(layers, loss::CrossEntropyLoss(), kwargs);
+}
+
+State getState() {
+  State state;
+  state.epoch = 3;
+  state.epochs = 10;
+  state.batch = 5;
+  state.learningRate = 1e-3;
+  state.seed = 42;
+  state.loss = 1.5;
+  state.confusionMatrix = Eigen::MatrixXi{{1, 2}, {3, 4}};
+  return state;
+}
+
+class CheckpointFile : public test_filesystem::BaseFileSystemFixture {};
+#pragma endregion Fixtures
+
+#pragma region Tests
+#pragma region State
+TEST(Checkpoint, TestStateToJson) {
+  json expected{{"epoch", 3},
+                {"epochs", 10},
+                {"batch", 5},
+                {"learning_rate", 1e-3},
+                {"seed", 42},
+                {"loss", 1.5},
+                {"confusion_matrix", {{1, 2}, {3, 4}}}};
+  ASSERT_EQ(expected, getState().toJson());
+}
+
+TEST(Checkpoint, TestStateFromJson) {
+  State state = State::fromJson(getState().toJson());
+  EXPECT_EQ(3, state.epoch);
+  EXPECT_EQ(10, state.epochs);
+  EXPECT_EQ(5, state.batch);
+  EXPECT_DOUBLE_EQ(1e-3, state.learningRate);
+  EXPECT_EQ(42, state.seed);
+  EXPECT_FLOAT_EQ(1.5, state.loss);
+  EXPECT_EQ(getState().confusionMatrix, state.confusionMatrix);
+}
+#pragma endregion State
+
+#pragma region Checkpointer
+TEST_F(CheckpointFile, TestSaveAndLoad) {
+  model::Model expected = getModel();
+  std::filesystem::path path = this->root / "checkpoints" / "model.json";
+  {
+    Checkpointer checkpointer(path);
+    checkpointer.save(expected, getState());
+  }
+  ASSERT_TRUE(std::filesystem::exists(path));
+  ASSERT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+
+  auto [model, state] = load(path);
+  EXPECT_EQ(expected, model);
+  EXPECT_EQ(expected.getTotalEpochs(), model.getTotalEpochs());
+  EXPECT_EQ(expected.getClasses(), model.getClasses());
+  EXPECT_EQ(getState().toJson(), state.toJson());
+}
+
+TEST_F(CheckpointFile, TestSaveKeepsLatest) {
+  model::Model expected = getModel();
+  std::filesystem::path path = this->root / "model.json";
+  {
+    Checkpointer checkpointer(path);
+    State state = getState();
+    for (int i = 0; i < 5; ++i) {
+      state.epoch = i;
+      checkpointer.save(expected, state);
+    }
+  }
+  EXPECT_EQ(4, load(path).second.epoch);
+}
+
+TEST_F(CheckpointFile, TestSaveUpdatesSnapshot) {
+  model::Model model = getModel();
+  std::filesystem::path path = this->root / "model.json";
+  {
+    Checkpointer checkpointer(path);
+    checkpointer.save(model, getState());
+    std::vector<linear::Linear> layers = model.getLayers();
+    layers[0].setWeight(Eigen::MatrixXd::Ones(3, 4));
+    model.setLayers(layers);
+    model.setTotalEpochs(5);
+    checkpointer.save(model, getState());
+    checkpointer.save(model, getState());
+  }
+
+  model::Model loaded = load(path).first;
+  EXPECT_EQ(model, loaded);
+  EXPECT_EQ(5, loaded.getTotalEpochs());
+  EXPECT_FALSE(model.getEval());
+}
+
+TEST_F(CheckpointFile, TestFailedWriteKeepsPrevious) {
+  model::Model model = getModel();
+  std::filesystem::path path = this->root / "model.json";
+  {
+    Checkpointer checkpointer(path);
+    checkpointer.save(model, getState());
+  }
+
+  // The temporary file cannot be opened for writing while it is a directory
+  std::filesystem::create_directories(path.string() + ".tmp/blocker");
+  testing::internal::CaptureStdout();
+  {
+    Checkpointer checkpointer(path);
+    State state = getState();
+    state.epoch = 4;
+    checkpointer.save(model, state);
+  }
+  EXPECT_NE(std::string::npos,
+            testing::internal::GetCapturedStdout().find(
+                "Failed to write the checkpoint to"));
+  EXPECT_EQ(getState().toJson(), load(path).second.toJson());
+}
+
+TEST_F(CheckpointFile, TestInvalidExtension) {
+  EXPECT_THROW(Checkpointer(this->root / "model.txt"),
+               exceptions::model::InvalidExtensionException);
+  EXPECT_THROW(load(this->root / "model.txt"),
+               exceptions::model::InvalidExtensionException);
+}
+
+TEST_F(CheckpointFile, TestLoadWithoutState) {
+  std::filesystem::path path = this->root / "model.json";
+  getModel().save(path);
+  EXPECT_THROW(load(path), exceptions::checkpoint::MissingStateException);
+}
+#pragma endregion Checkpointer
+#pragma endregion Tests
+} // namespace test_checkpoint
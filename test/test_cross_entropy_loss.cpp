@@ -247,6 +247,18 @@ TEST_P(TestCrossEntropyLoss, TestForward) {
   ASSERT_EQ(lossValue, loss.forward(logits, labels)) << "Forward with labels.";
 }
 
+TEST_P(TestCrossEntropyLoss, TestEvaluate) {
+  CrossEntropyLoss loss(GetParam().reduction);
+  auto [logits, oneHot, labels] = getData(GetParam().dataSize);
+  double lossValue = getLoss(GetParam().reduction, GetParam().dataSize);
+  ASSERT_EQ(lossValue, loss.evaluate(logits, oneHot))
+      << "Evaluate with one hot encoded.";
+  ASSERT_EQ(lossValue, loss.evaluate(logits, labels))
+      << "Evaluate with labels.";
+  EXPECT_EQ(0, loss.getCacheSize())
+      << "Evaluate saved the inputs for the backward pass.";
+}
+
 TEST(CrossEntropyLoss, TestForwardWithMissingValues) {
   CrossEntropyLoss loss;
   Eigen::MatrixXd logits{{1, 1, 1}};
@@ -0,0 +1,74 @@
+#include "early_stopping.hpp"
+#include "exceptions/early_stopping.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace early_stopping;
+
+namespace test_early_stopping {
+#pragma region Tests
+#pragma region Init
+TEST(EarlyStopping, TestInit) {
+  EarlyStopping earlyStopping("loss", 2, 0.1);
+  EXPECT_EQ("loss", earlyStopping.getMetric());
+  EXPECT_EQ(0, earlyStopping.getBestEpoch());
+  EXPECT_FALSE(earlyStopping.shouldStop());
+}
+
+TEST(EarlyStopping, TestInitWithInvalidMetric) {
+  for (const std::string &metric :
+       {"precision", "confidence_histogram", "invalid"}) {
+    EXPECT_THROW(EarlyStopping(metric, 1, 0),
+                 exceptions::early_stopping::InvalidMetricException)
+        << metric;
+  }
+}
+
+TEST(EarlyStopping, TestInitWithInvalidPatience) {
+  EXPECT_THROW(EarlyStopping("loss", 0, 0),
+               exceptions::early_stopping::InvalidPatienceException);
+}
+
+TEST(EarlyStopping, TestInitWithInvalidMinDelta) {
+  EXPECT_THROW(EarlyStopping("loss", 1, -0.1),
+               exceptions::early_stopping::InvalidMinDeltaException);
+}
+#pragma endregion Init
+
+#pragma region Update
+TEST(EarlyStopping, TestUpdateLowerIsBetter) {
+  EarlyStopping earlyStopping("loss", 2, 0);
+  std::vector<float> values{1, 0.5, 0.5, 0.6};
+  std::vector<bool> expected{true, true, false, false};
+  for (int i = 0; i < values.size(); ++i) {
+    EXPECT_FALSE(earlyStopping.shouldStop()) << "Epoch " << i + 1;
+    EXPECT_EQ(expected[i], earlyStopping.update(values[i], i + 1))
+        << "Epoch " << i + 1;
+  }
+  EXPECT_TRUE(earlyStopping.shouldStop());
+  EXPECT_EQ(2, earlyStopping.getBestEpoch());
+  EXPECT_FLOAT_EQ(0.5, earlyStopping.getBest());
+}
+
+TEST(EarlyStopping, TestUpdateHigherIsBetter) {
+  EarlyStopping earlyStopping("accuracy", 1, 0);
+  EXPECT_TRUE(earlyStopping.update(0.5, 1));
+  EXPECT_TRUE(earlyStopping.update(0.6, 2));
+  EXPECT_FALSE(earlyStopping.shouldStop());
+  EXPECT_FALSE(earlyStopping.update(0.4, 3));
+  EXPECT_TRUE(earlyStopping.shouldStop());
+  EXPECT_EQ(2, earlyStopping.getBestEpoch());
+}
+
+TEST(EarlyStopping, TestUpdateWithMinDelta) {
+  EarlyStopping earlyStopping("accuracy", 2, 0.1);
+  EXPECT_TRUE(earlyStopping.update(0.5, 1));
+  EXPECT_FALSE(earlyStopping.update(0.55, 2));
+  EXPECT_TRUE(earlyStopping.update(0.7, 3));
+  EXPECT_FALSE(earlyStopping.shouldStop());
+  EXPECT_EQ(3, earlyStopping.getBestEpoch());
+}
+#pragma endregion Update
+#pragma endregion Tests
+} // namespace test_early_stopping
@@ -266,6 +266,31 @@ TEST_P(TestDatasetBatcher, TestDatasetBatcherIndexOutOfRange) {
   EXPECT_THROW(batcher[-1], std::out_of_range)
       << "Did not throw out of range for negative numbers.";
 }
+
+TEST_F(ImageLoaderFileSystem, TestDatasetBatcherSeededShuffle) {
+  std::vector<std::filesystem::path> files = utils::path::glob(root, {".png"});
+  std::sort(files.begin(), files.end());
+  DatasetBatcher::KeywordArgs kwargs;
+  kwargs.seed = 42;
+  DatasetBatcher first(root, files, {utils::matrix::flatten},
+                       {{"0", 0}, {"1", 1}, {"2", 2}}, 1, kwargs),
+      second(root, files, {utils::matrix::flatten},
+             {{"0", 0}, {"1", 1}, {"2", 2}}, 1, kwargs);
+  for (int i = 0; i < first.size(); ++i) {
+    ASSERT_EQ(first[i].second, second[i].second)
+        << "Labels do not match on batch " << i << ".";
+  }
+}
+
+TEST_F(ImageLoaderFileSystem, TestDatasetBatcherStratifiedSample) {
+  DatasetBatcher::KeywordArgs kwargs;
+  kwargs.samples = 2;
+  DatasetBatcher batcher(root, utils::path::glob(root, {".png"}),
+                         {utils::matrix::flatten},
+                         {{"0", 0}, {"1", 1}, {"2", 2}}, 1, kwargs);
+  ASSERT_EQ(2, batcher.size());
+  EXPECT_NE(batcher[0].second, batcher[1].second);
+}
 #pragma endregion Index
 
 #pragma region Range based for loop
@@ -324,4 +349,77 @@ INSTANTIATE_TEST_SUITE_P(, TestDatasetBatcher,
                                            DatasetBatcherData(4, 0, true)));
 #pragma endregion Data
 #pragma endregion Dataset batcher
+
+#pragma region In memory image loader
+#pragma region Init
+TEST_F(ImageLoaderFileSystem, TestInMemoryImageLoaderInit) {
+  ImageLoader source(root, {utils::matrix::flatten}, {".png"}, (float)2 / 3,
+                     false);
+  InMemoryImageLoader loader(source);
+  EXPECT_EQ(source.getClasses(), loader.getClasses());
+}
+#pragma endregion Init
+
+#pragma region Batcher
+TEST_F(ImageLoaderFileSystem, TestInMemoryImageLoaderGetBatcher) {
+  ImageLoader source(root, {utils::matrix::flatten}, {".png"}, (float)2 / 3,
+                     false);
+  InMemoryImageLoader loader(source);
+  DatasetBatcher::KeywordArgs kwargs;
+  kwargs.shuffle = false;
+  for (const std::string &dataset : {"train", "test"}) {
+    for (int batchSize = 1; batchSize <= 3; ++batchSize) {
+      std::shared_ptr<DatasetBatcher> expected =
+          source(dataset, batchSize, kwargs);
+      std::shared_ptr<DatasetBatcher> result =
+          loader(dataset, batchSize, kwargs);
+      ASSERT_EQ(expected->size(), result->size())
+          << "Sizes do not match for " << dataset << " with batch size "
+          << batchSize << ".";
+      for (int i = 0; i < expected->size(); ++i) {
+        auto [expectedData, expectedLabels] = (*expected)[i];
+        auto [resultData, resultLabels] = (*result)[i];
+        EXPECT_EQ(expectedLabels, resultLabels)
+            << "Labels do not match on batch " << i << ".";
+        EXPECT_TRUE(expectedData.isApprox(resultData))
+            << "Data does not match on batch " << i << ".";
+      }
+    }
+  }
+}
+
+TEST_F(ImageLoaderFileSystem, TestInMemoryImageLoaderGetBatcherWithOptions) {
+  InMemoryImageLoader loader(
+      ImageLoader(root, {utils::matrix::flatten}, {".png"}, 1, false));
+  DatasetBatcher::KeywordArgs kwargs;
+  kwargs.dropLast = true;
+  EXPECT_EQ(1, loader("train", 2, kwargs)->size());
+
+  kwargs = DatasetBatcher::KeywordArgs();
+  kwargs.seed = 42;
+  std::shared_ptr<DatasetBatcher> first = loader("train", 1, kwargs),
+                                  second = loader("train", 1, kwargs);
+  for (int i = 0; i < first->size(); ++i) {
+    ASSERT_EQ((*first)[i].second, (*second)[i].second)
+        << "Labels do not match on batch " << i << ".";
+  }
+
+  kwargs.samples = 2;
+  std::shared_ptr<DatasetBatcher> sample = loader("train", 1, kwargs);
+  ASSERT_EQ(2, sample->size());
+  EXPECT_NE((*sample)[0].second, (*sample)[1].second);
+  EXPECT_THROW((*sample)[2], std::out_of_range);
+  EXPECT_THROW((*sample)[-1], std::out_of_range);
+}
+
+TEST_F(ImageLoaderFileSystem, TestInMemoryImageLoaderGetBatcherWithInvalid) {
+  InMemoryImageLoader loader(
+      ImageLoader(root, {utils::matrix::flatten}, {".png"}, 1, false));
+  EXPECT_THROW(loader("validation", 1),
+               exceptions::loader::InvalidDatasetException);
+  EXPECT_THROW(loader("train", 0),
+               exceptions::loader::InvalidBatchSizeException);
+}
+#pragma endregion Batcher
+#pragma endregion In memory image loader
 } // namespace test_image_loader
\ No newline at end of file
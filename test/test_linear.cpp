@@ -173,6 +173,22 @@ TEST(Linear, TestInitWithInvalidActivationFunction) {
   EXPECT_THROW(Linear(1, 2, "INVALID"),
                exceptions::activation::InvalidActivationException);
 }
+
+TEST(Linear, TestInitWithParameters) {
+  Eigen::MatrixXd weight{{1, 2, 3}, {4, 5, 6}};
+  Eigen::VectorXd bias{{1, 2}};
+  Linear layer(weight, bias, "ReLU");
+  ASSERT_EQ(3, layer.inChannels);
+  ASSERT_EQ(2, layer.outChannels);
+  ASSERT_EQ(getLayer("ReLU"), layer);
+}
+
+TEST(Linear, TestInitWithMismatchedParameters) {
+  Eigen::MatrixXd weight{{1, 2, 3}, {4, 5, 6}};
+  Eigen::VectorXd bias{{1, 2, 3}};
+  EXPECT_THROW(Linear(weight, bias),
+               exceptions::eigen::InvalidShapeException);
+}
 #pragma endregion Init
 
 #pragma region Properties
@@ -232,6 +248,22 @@ TEST(Linear, TestActivationFunction) {
   ASSERT_EQ(*layer.getActivation(), activation_functions::NoActivation());
 }
 #pragma endregion Activation function
+
+#pragma region Memory
+TEST(Linear, TestMemory) {
+  Linear layer = getLayer("ReLU");
+  EXPECT_EQ((6 + 2) * sizeof(double), layer.getParameterSize());
+  EXPECT_EQ(0, layer.getCacheSize());
+
+  // The input to the layer and to the activation function are both saved.
+  layer.forward(Eigen::MatrixXd::Ones(4, 3));
+  EXPECT_EQ((4 * 3 + 4 * 2) * sizeof(double), layer.getCacheSize());
+
+  layer.setEval(true);
+  layer.forward(Eigen::MatrixXd::Ones(4, 3));
+  EXPECT_EQ(4 * 2 * sizeof(double), layer.getCacheSize());
+}
+#pragma endregion Memory
 #pragma endregion Properties
 
 #pragma region Load
@@ -290,6 +322,17 @@ TEST_P(TestLinear, TestForward) {
       << X << "\n"
       << Y << "\n";
 }
+
+TEST_P(TestLinear, TestInfer) {
+  Linear layer = GetParam().layer;
+  auto [X, Y] =
+      getForwardData(GetParam().dataSize, layer.getActivation()->getName());
+  std::size_t cacheSize = layer.getCacheSize();
+  Eigen::MatrixXd output = layer.infer(X);
+  EXPECT_EQ(cacheSize, layer.getCacheSize())
+      << "Infer saved the input for the backward pass.";
+  ASSERT_EQ(layer.forward(X), output);
+}
 #pragma endregion Forward pass
 
 #pragma region Backward pass
@@ -348,6 +391,22 @@ TEST_P(TestLinear, TestUpdate) {
   ASSERT_TRUE(trueWeight.isApprox(layer.getWeight()));
   ASSERT_TRUE(trueBias.isApprox(layer.getBias()));
 }
+
+TEST(Linear, TestSmallBatch) {
+  // Small batches are multiplied one row at a time.
+  auto [X, Y] = getLarge("NoActivation");
+  auto [grad, trueInputGrad, _, __] = getLargeGrad("NoActivation");
+  for (int batchSize : {2, 8}) {
+    Linear layer = getLayer();
+    ASSERT_TRUE(Y.topRows(batchSize).isApprox(layer(X.topRows(batchSize))))
+        << "Forward with a batch size of " << batchSize << " does not match.";
+    auto [inputGrad, weightGrad, biasGrad] =
+        layer.backward(grad.topRows(batchSize));
+    ASSERT_TRUE(trueInputGrad.topRows(batchSize).isApprox(inputGrad))
+        << "Input grad with a batch size of " << batchSize
+        << " does not match.";
+  }
+}
 #pragma endregion Backward pass
 
 #pragma region Builtins
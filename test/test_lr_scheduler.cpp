@@ -0,0 +1,100 @@
+#include "exceptions/lr_scheduler.hpp"
+#include "lr_scheduler.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace lr_scheduler;
+
+namespace test_lr_scheduler {
+#pragma region Fixtures
+Scheduler::KeywordArgs getKwargs(Schedule schedule) {
+  Scheduler::KeywordArgs kwargs;
+  kwargs.schedule = schedule;
+  return kwargs;
+}
+#pragma endregion Fixtures
+
+#pragma region Tests
+#pragma region Schedule
+TEST(LRScheduler, TestScheduleFromString) {
+  EXPECT_EQ(Schedule::CONSTANT, scheduleFromString("constant"));
+  EXPECT_EQ(Schedule::STEP, scheduleFromString("step"));
+  EXPECT_EQ(Schedule::COSINE, scheduleFromString("cosine"));
+  EXPECT_EQ(Schedule::ONE_CYCLE, scheduleFromString("one_cycle"));
+  EXPECT_THROW(scheduleFromString("linear"),
+               exceptions::lr_scheduler::InvalidScheduleException);
+}
+#pragma endregion Schedule
+
+#pragma region Init
+TEST(LRScheduler, TestInitWithInvalidParameters) {
+  std::vector<Scheduler::KeywordArgs> invalid(5);
+  invalid[0].warmupEpochs = -1;
+  invalid[1].stepEpochs = 0;
+  invalid[2].gamma = 0;
+  invalid[3].minLearningRate = -1;
+  invalid[4].minLearningRate = 2;
+  for (int i = 0; i < invalid.size(); ++i) {
+    EXPECT_THROW(Scheduler(1, 1, 1, invalid[i]),
+                 exceptions::lr_scheduler::InvalidParameterException)
+        << "Test " << i << " did not throw.";
+  }
+}
+#pragma endregion Init
+
+#pragma region Learning rate
+TEST(LRScheduler, TestConstant) {
+  Scheduler scheduler(0.1, 2, 3);
+  EXPECT_TRUE(scheduler.isConstant());
+  for (int step = -1; step < 8; ++step) {
+    EXPECT_DOUBLE_EQ(0.1, scheduler(step)) << "Step " << step;
+  }
+}
+
+TEST(LRScheduler, TestWarmup) {
+  Scheduler::KeywordArgs kwargs;
+  kwargs.warmupEpochs = 1;
+  Scheduler scheduler(1, 2, 5, kwargs);
+  EXPECT_FALSE(scheduler.isConstant());
+  std::vector<double> expected{0.2, 0.4, 0.6, 0.8, 1, 1, 1};
+  for (int step = 0; step < expected.size(); ++step) {
+    EXPECT_DOUBLE_EQ(expected[step], scheduler(step)) << "Step " << step;
+  }
+}
+
+TEST(LRScheduler, TestStep) {
+  Scheduler::KeywordArgs kwargs = getKwargs(Schedule::STEP);
+  kwargs.gamma = 0.5;
+  Scheduler scheduler(1, 4, 2, kwargs);
+  std::vector<double> expected{1, 1, 0.5, 0.5, 0.25, 0.25, 0.125, 0.125};
+  for (int step = 0; step < expected.size(); ++step) {
+    EXPECT_DOUBLE_EQ(expected[step], scheduler(step)) << "Step " << step;
+  }
+}
+
+TEST(LRScheduler, TestCosine) {
+  Scheduler::KeywordArgs kwargs = getKwargs(Schedule::COSINE);
+  kwargs.minLearningRate = 0.2;
+  Scheduler scheduler(1, 1, 4, kwargs);
+  EXPECT_DOUBLE_EQ(1, scheduler(0));
+  EXPECT_DOUBLE_EQ(0.6, scheduler(2));
+  EXPECT_GT(scheduler(3), 0.2);
+  EXPECT_LT(scheduler(3), scheduler(2));
+}
+
+TEST(LRScheduler, TestOneCycle) {
+  Scheduler scheduler(1, 1, 10, getKwargs(Schedule::ONE_CYCLE));
+  EXPECT_DOUBLE_EQ(0.04, scheduler(0));
+  for (int step = 1; step < 3; ++step) {
+    EXPECT_GT(scheduler(step), scheduler(step - 1)) << "Step " << step;
+  }
+  EXPECT_DOUBLE_EQ(1, scheduler(3));
+  for (int step = 4; step < 10; ++step) {
+    EXPECT_LT(scheduler(step), scheduler(step - 1)) << "Step " << step;
+  }
+  EXPECT_GT(scheduler(9), 0);
+}
+#pragma endregion Learning rate
+#pragma endregion Tests
+} // namespace test_lr_scheduler
@@ -1,5 +1,7 @@
 #include "exceptions/metrics.hpp"
+#include "metric_history.hpp"
 #include "metrics.hpp"
+#include "utils/math.hpp"
 #include "utils/matrix.hpp"
 #include <Eigen/Dense>
 #include <algorithm>
@@ -8,6 +10,7 @@
 #include <map>
 #include <nlohmann/json.hpp>
 #include <ostream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -73,6 +76,41 @@ TEST(Metrics, TestAddToConfusionMatrixWithInvalidInputs) {
       << "Did not throw exception when size of predicted and actual is "
          "mismatched.";
 }
+
+TEST(Metrics, TestAddLogitsToConfusionMatrix) {
+  Eigen::MatrixXd logits{{1, 2, 3}, {-1, 5, 0}, {4, 4, -2}, {0.5, -3, 0.1}};
+  std::vector<int> actual{2, 1, 0, 1};
+  Eigen::MatrixXi expected = getNewConfusionMatrix(3),
+                  matrix = getNewConfusionMatrix(3);
+  addToConfusionMatrix(expected, utils::math::logitsToPrediction(logits),
+                       actual);
+  addToConfusionMatrix(matrix, logits, actual);
+  ASSERT_EQ(expected, matrix);
+}
+
+TEST(Metrics, TestAddLogitsToConfusionMatrixWithInvalidInputs) {
+  Eigen::MatrixXd logits{{1, 2, 3}, {-1, 5, 0}};
+  std::vector<int> actual{1};
+  Eigen::MatrixXi matrix = getNewConfusionMatrix(3);
+  EXPECT_THROW(addToConfusionMatrix(matrix, logits, actual),
+               exceptions::metrics::InvalidDatasetException)
+      << "Did not throw exception when size of logits and actual is "
+         "mismatched.";
+}
+
+TEST(Metrics, TestMergeConfusionMatrix) {
+  Eigen::MatrixXi matrix{{1, 0}, {2, 3}}, other{{0, 4}, {1, 1}},
+      expected{{1, 4}, {3, 4}};
+  mergeConfusionMatrix(matrix, other);
+  ASSERT_EQ(expected, matrix);
+}
+
+TEST(Metrics, TestMergeConfusionMatrixWithInvalidInputs) {
+  Eigen::MatrixXi matrix = getNewConfusionMatrix(2);
+  EXPECT_THROW(mergeConfusionMatrix(matrix, getNewConfusionMatrix(3)),
+               exceptions::metrics::MismatchedConfusionMatrixException)
+      << "Did not throw exception when the number of classes is mismatched.";
+}
 #pragma endregion Confusion matrix
 
 #pragma region Metrics
@@ -190,4 +228,57 @@ TEST(Metrics, F1Score) {
   }
 }
 #pragma endregion F1 score
-#pragma endregion Metrics
\ No newline at end of file
+
+#pragma region Accuracy interval
+TEST(Metrics, AccuracyInterval) {
+  auto [lower, upper] = accuracyInterval(Eigen::MatrixXi{{5, 1}, {1, 3}});
+  EXPECT_NEAR(0.4902, lower, 1e-4);
+  EXPECT_NEAR(0.9433, upper, 1e-4);
+
+  std::tie(lower, upper) = accuracyInterval(Eigen::MatrixXi{{4, 0}, {0, 6}});
+  EXPECT_LT(lower, 1);
+  EXPECT_FLOAT_EQ(1, upper);
+
+  std::tie(lower, upper) = accuracyInterval(Eigen::MatrixXi::Zero(2, 2));
+  EXPECT_FLOAT_EQ(0, lower);
+  EXPECT_FLOAT_EQ(1, upper);
+}
+#pragma endregion Accuracy interval
+#pragma endregion Metrics
+#pragma region Metric history
+TEST(Metrics, TestMetricHistoryPushBack) {
+  MetricHistory history;
+  EXPECT_TRUE(history.empty());
+  EXPECT_EQ(0, history.size());
+
+  history.push_back(std::vector<float>{1, 2, 3});
+  history.push_back(std::vector<float>{4, 5, 6});
+  EXPECT_EQ(2, history.size());
+  EXPECT_EQ(3, history.getWidth());
+  EXPECT_EQ(6 * sizeof(float), history.getSize());
+  EXPECT_EQ((std::vector<float>{4, 5, 6}),
+            std::vector<float>(history.back().begin(), history.back().end()));
+  EXPECT_EQ(MetricHistory({1, 2, 3, 4, 5, 6}, 3), history);
+
+  MetricHistory single;
+  single.push_back(0.5f);
+  single.push_back(0.25f);
+  EXPECT_EQ(1, single.getWidth());
+  EXPECT_FLOAT_EQ(0.25, single[1][0]);
+  EXPECT_EQ(MetricHistory({0.5, 0.25}, 1), single);
+}
+
+TEST(Metrics, TestMetricHistoryWithInvalidWidth) {
+  MetricHistory history;
+  history.push_back(std::vector<float>{1, 2, 3});
+  EXPECT_THROW(history.push_back(1),
+               exceptions::metrics::InvalidHistoryWidthException);
+  EXPECT_THROW(history.push_back(std::vector<float>{1, 2}),
+               exceptions::metrics::InvalidHistoryWidthException);
+  EXPECT_THROW(MetricHistory({1, 2, 3}, 2),
+               exceptions::metrics::InvalidHistoryWidthException);
+  EXPECT_THROW(MetricHistory({1}, 0),
+               exceptions::metrics::InvalidHistoryWidthException);
+  EXPECT_THROW(history[1], std::out_of_range);
+}
+#pragma endregion Metric history
\ No newline at end of file
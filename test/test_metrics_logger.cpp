@@ -0,0 +1,141 @@
+#include "exceptions/metrics_logger.hpp"
+#include "fixtures.hpp"
+#include "metrics_logger.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace metrics_logger;
+using json = nlohmann::json;
+
+namespace test_metrics_logger {
+#pragma region Fixtures
+Record getRecord(const std::string &split = "train") {
+  return Record{
+      .split = split,
+      .epoch = 2,
+      .batch = 5,
+      .batches = 10,
+      .samples = 40,
+      .seconds = 2,
+      .metrics = {{"loss", 0.5f}, {"precision", std::vector<float>{1, 0}}}};
+}
+
+std::vector<std::string> getLines(const std::filesystem::path &path) {
+  std::ifstream file(path);
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(file, line);) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+class MetricsLogFile : public test_filesystem::BaseFileSystemFixture {};
+#pragma endregion Fixtures
+
+#pragma region Tests
+#pragma region Record
+TEST(MetricsLogger, TestSamplesPerSecond) {
+  Record record = getRecord();
+  EXPECT_DOUBLE_EQ(20, record.getSamplesPerSecond());
+  record.seconds = 0;
+  EXPECT_DOUBLE_EQ(0, record.getSamplesPerSecond());
+}
+
+TEST(MetricsLogger, TestRecordToJson) {
+  Record record = getRecord();
+  record.timings = {{"Load batch", 1.5, 5}};
+  json values = record.toJson({"cat", "dog"});
+  EXPECT_TRUE(values.contains("timestamp"));
+  values.erase("timestamp");
+
+  json expected{{"split", "train"},
+                {"epoch", 2},
+                {"batch", 5},
+                {"batches", 10},
+                {"samples", 40},
+                {"seconds", 2.0},
+                {"samples_per_second", 20.0},
+                {"metrics",
+                 {{"loss", 0.5}, {"precision", {{"cat", 1.0}, {"dog", 0.0}}}}},
+                {"timings", {{"Load batch", 1.5}}}};
+  ASSERT_EQ(expected, values);
+}
+
+TEST(MetricsLogger, TestRecordToJsonBinned) {
+  Record record = getRecord();
+  record.metrics = {{"confidence_histogram", std::vector<float>{0.25, 0.75}}};
+  json values = record.toJson({"cat", "dog", "bird"});
+  json expected{0.25, 0.75};
+  ASSERT_EQ(expected, values["metrics"]["confidence_histogram"]);
+}
+
+TEST(MetricsLogger, TestRecordToJsonBinnedPerClassSize) {
+  Record record = getRecord();
+  record.metrics = {{"confidence_histogram", std::vector<float>{0.25, 0.75}}};
+  json values = record.toJson({"cat", "dog"});
+  json expected{0.25, 0.75};
+  ASSERT_EQ(expected, values["metrics"]["confidence_histogram"]);
+}
+#pragma endregion Record
+
+#pragma region Metrics logger
+TEST_F(MetricsLogFile, TestFormat) {
+  EXPECT_EQ(Format::JSONL,
+            MetricsLogger(this->root / "metrics.jsonl", {}).getFormat());
+  EXPECT_EQ(Format::PROMETHEUS,
+            MetricsLogger(this->root / "metrics.prom", {}).getFormat());
+}
+
+TEST_F(MetricsLogFile, TestInvalidExtension) {
+  std::vector<std::string> extensions{".json", ".txt", ""};
+  for (const std::string &extension : extensions) {
+    EXPECT_THROW(MetricsLogger(this->root / ("metrics" + extension), {}),
+                 exceptions::metrics_logger::InvalidExtensionException)
+        << "Exception did not throw for " << extension;
+  }
+}
+
+TEST_F(MetricsLogFile, TestLogJsonl) {
+  std::filesystem::path path = this->root / "logs" / "metrics.jsonl";
+  MetricsLogger logger(path, {"cat", "dog"});
+  logger.log(getRecord());
+  logger.log(getRecord("validation"));
+
+  std::vector<std::string> lines = getLines(path);
+  ASSERT_EQ(2, lines.size());
+  EXPECT_EQ("train", json::parse(lines[0])["split"]);
+  EXPECT_EQ("validation", json::parse(lines[1])["split"]);
+}
+
+TEST_F(MetricsLogFile, TestLogPrometheus) {
+  std::filesystem::path path = this->root / "metrics.prom";
+  MetricsLogger logger(path, {"cat", "dog"});
+  logger.log(getRecord());
+  Record record = getRecord();
+  record.batch = 10;
+  record.metrics["confidence_histogram"] = std::vector<float>{0.25, 0.75};
+  logger.log(record);
+
+  std::vector<std::string> lines = getLines(path);
+  auto contains = [&lines](const std::string &line) {
+    return std::find(lines.begin(), lines.end(), line) != lines.end();
+  };
+  EXPECT_TRUE(contains("# TYPE nn_loss gauge"));
+  EXPECT_TRUE(contains("nn_loss{split=\"train\"} 0.5"));
+  EXPECT_TRUE(contains("nn_precision{split=\"train\",class=\"dog\"} 0"));
+  EXPECT_TRUE(
+      contains("nn_confidence_histogram{split=\"train\",bin=\"1\"} 0.75"));
+  EXPECT_TRUE(contains("nn_samples_per_second{split=\"train\"} 20"));
+  EXPECT_TRUE(contains("nn_batch{split=\"train\"} 10"));
+  EXPECT_FALSE(contains("nn_batch{split=\"train\"} 5"));
+  EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+}
+#pragma endregion Metrics logger
+#pragma endregion Tests
+} // namespace test_metrics_logger
\ No newline at end of file
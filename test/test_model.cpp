@@ -1,9 +1,19 @@
+#include "activation_functions.hpp"
+#include "checkpoint.hpp"
 #include "cross_entropy_loss.hpp"
+#include "exceptions/activation_functions.hpp"
+#include "exceptions/early_stopping.hpp"
+#include "exceptions/eigen.hpp"
+#include "exceptions/json.hpp"
 #include "exceptions/model.hpp"
 #include "fixtures.hpp"
 #include "image_loader.hpp"
 #include "linear.hpp"
+#include "metrics.hpp"
 #include "model.hpp"
+#include "utils/allocations.hpp"
+#include "utils/trace.hpp"
+#include "utils/timer.hpp"
 #include <Eigen/Dense>
 #include <algorithm>
 #include <bits/std_abs.h>
@@ -14,6 +24,7 @@
 #include <map>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -129,6 +140,58 @@ struct MockLoader : public loader::ImageLoader {
   }
 };
 
+struct InterruptedDatasetBatcher : public MockDatasetBatcher {
+  int interruptAt;
+
+  InterruptedDatasetBatcher(const MockDatasetBatcher &batcher, int interruptAt)
+      : MockDatasetBatcher(batcher), interruptAt(interruptAt){};
+
+  loader::minibatch operator[](int i) const override {
+    if (i == this->interruptAt) {
+      throw std::runtime_error("Interrupted");
+    }
+    return MockDatasetBatcher::operator[](i);
+  };
+};
+
+struct InterruptedLoader : public MockLoader {
+  int interruptAt;
+
+  InterruptedLoader(float split, int interruptAt)
+      : MockLoader(split), interruptAt(interruptAt){};
+
+  std::shared_ptr<loader::DatasetBatcher>
+  getBatcher(std::string type, int batchSize,
+             const loader::DatasetBatcher::KeywordArgs &kwargs =
+                 loader::DatasetBatcher::KeywordArgs()) const override {
+    auto batcher = std::static_pointer_cast<MockDatasetBatcher>(
+        MockLoader::getBatcher(type, batchSize, kwargs));
+    if (type != "train") {
+      return batcher;
+    }
+    return std::make_shared<InterruptedDatasetBatcher>(*batcher,
+                                                       this->interruptAt);
+  }
+};
+
+struct SampledValidationLoader : public MockLoader {
+  mutable std::vector<int> samples;
+
+  SampledValidationLoader(float split) : MockLoader(split){};
+
+  std::shared_ptr<loader::DatasetBatcher>
+  getBatcher(std::string type, int batchSize,
+             const loader::DatasetBatcher::KeywordArgs &kwargs =
+                 loader::DatasetBatcher::KeywordArgs()) const override {
+    if (type == "test") {
+      this->samples.push_back(kwargs.samples);
+    }
+    return MockLoader::getBatcher(type, batchSize, kwargs);
+  }
+};
+
+class ModelMetricsLog : public test_filesystem::BaseFileSystemFixture {};
+
 class ModelJsonFile : public test_filesystem::BaseFileSystemFixture {
 protected:
   std::filesystem::path expected;
@@ -153,6 +216,34 @@ protected:
 #pragma endregion Fixtures
 
 #pragma region Tests
+#pragma region Architecture
+TEST(Model, TestBuildLayers) {
+  std::vector<linear::Linear> layers =
+      buildLayers(4, {{5, "ReLU"}, {3}, {2, "ReLU"}}, 2);
+  std::vector<std::tuple<int, int, std::string>> expected{
+      {4, 5, "ReLU"}, {5, 3, "NoActivation"}, {3, 2, "ReLU"}};
+  ASSERT_EQ(expected.size(), layers.size());
+  for (int i = 0; i < layers.size(); ++i) {
+    auto [inChannels, outChannels, activation] = expected[i];
+    EXPECT_EQ(inChannels, layers[i].inChannels) << "Layer " << i;
+    EXPECT_EQ(outChannels, layers[i].outChannels) << "Layer " << i;
+    EXPECT_EQ(activation, layers[i].getActivation()->getName())
+        << "Layer " << i;
+  }
+}
+
+TEST(Model, TestBuildLayersWithInvalidLayers) {
+  EXPECT_THROW(buildLayers(4, {}, 2),
+               exceptions::model::EmptyLayersVectorException);
+  EXPECT_THROW(buildLayers(4, {{0, "ReLU"}, {2}}, 2),
+               exceptions::model::InvalidLayerSizeException);
+  EXPECT_THROW(buildLayers(4, {{5, "ReLU"}, {3}}, 2),
+               exceptions::model::MismatchedOutputSizeException);
+  EXPECT_THROW(buildLayers(4, {{5, "Sigmoid"}, {2}}, 2),
+               exceptions::activation::InvalidActivationException);
+}
+#pragma endregion Architecture
+
 #pragma region Init
 TEST(Model, TestInitWithInvalidTotalEpochs) {
   std::vector<linear::Linear> layers = getLayers();
@@ -263,15 +354,11 @@ TEST(Model, TestLoad) {
   std::vector<std::string> classes = {"0", "1"};
   int totalEpochs = 10;
   std::unordered_map<std::string, metricHistoryValue> trainMetrics{
-      {"loss", {(float)1, (float)2, (float)3}},
-      {"recall",
-       {(std::vector<float>){1, 2, 3}, (std::vector<float>){4, 5, 6},
-        (std::vector<float>){7, 8, 9}}}},
+      {"loss", metricHistoryValue({1, 2, 3}, 1)},
+      {"recall", metricHistoryValue({1, 2, 3, 4, 5, 6, 7, 8, 9}, 3)}},
       validationMetrics{
-          {"loss", {(float)3, (float)2, (float)1}},
-          {"recall",
-           {(std::vector<float>){9, 8, 7}, (std::vector<float>){6, 5, 4},
-            (std::vector<float>){3, 2, 1}}}};
+          {"loss", metricHistoryValue({3, 2, 1}, 1)},
+          {"recall", metricHistoryValue({9, 8, 7, 6, 5, 4, 3, 2, 1}, 3)}};
 
   json attributes;
   attributes["class"] = "Model";
@@ -309,6 +396,81 @@ TEST_F(ModelJsonFile, TestLoad) {
   EXPECT_EQ(expected.getClasses(), model.getClasses());
 }
 
+TEST_F(ModelJsonFile, TestLoadRoundTrip) {
+  std::vector<linear::Linear> layers{linear::Linear(30, 20, "ReLU"),
+                                     linear::Linear(20, 5)};
+  Model expected(layers, getLoss(), getKwargs());
+  std::filesystem::path path = this->root / "model.json";
+  expected.save(path);
+
+  Model model = Model::load(path);
+  EXPECT_EQ(expected.getLayers(), model.getLayers());
+  EXPECT_EQ(expected.getClasses(), model.getClasses());
+}
+
+TEST_F(ModelJsonFile, TestLoadInvalidLayerParameters) {
+  auto writeModel = [&](const std::string &weight, const std::string &bias) {
+    std::filesystem::path path = this->root / "invalid.json";
+    std::ofstream file(path);
+    file << "{\"class\": \"Model\", \"layers\": [{\"class\": \"Linear\", "
+            "\"weight\": "
+         << weight << ", \"bias\": " << bias
+         << ", \"activation_function\": \"NoActivation\"}], \"loss\": "
+            "{\"class\": \"CrossEntropyLoss\", \"reduction\": \"sum\"}, "
+            "\"total_epochs\": 0, \"train_metrics\": {}, "
+            "\"validation_metrics\": {}, \"classes\": []}";
+    file.close();
+    return path;
+  };
+
+  std::vector<std::string> weights{"[[1.0, 1.0], [1.0]]", "[1.0, 1.0]",
+                                   "[[[1.0]]]"};
+  for (const std::string &weight : weights) {
+    EXPECT_THROW(Model::load(writeModel(weight, "[1.0]")),
+                 exceptions::json::JSONArray2DException)
+        << "Exception did not throw for " << weight;
+  }
+  EXPECT_THROW(Model::load(writeModel("[[1.0]]", "[[1.0]]")),
+               exceptions::json::JSONArray1DException);
+  EXPECT_THROW(Model::load(writeModel("[[1.0], [\"1.0\"]]", "[1.0]")),
+               exceptions::json::JSONTypeException);
+  EXPECT_THROW(Model::load(writeModel("[[1.0], [1.0]]", "[1.0]")),
+               exceptions::eigen::InvalidShapeException);
+}
+
+TEST_F(ModelJsonFile, TestLoadMissingLayerParameters) {
+  auto writeModel = [&](const std::string &layers) {
+    std::filesystem::path path = this->root / "truncated.json";
+    std::ofstream file(path);
+    file << "{\"class\": \"Model\", \"layers\": [" << layers
+         << "], \"loss\": {\"class\": \"CrossEntropyLoss\", "
+            "\"reduction\": \"sum\"}, \"total_epochs\": 0, "
+            "\"train_metrics\": {}, \"validation_metrics\": {}, "
+            "\"classes\": []}";
+    file.close();
+    return path;
+  };
+  auto layer = [](const std::string &parameters) {
+    return "{\"class\": \"Linear\", " + parameters +
+           "\"activation_function\": \"NoActivation\"}";
+  };
+
+  std::vector<std::string> truncated{
+      layer(""), layer("\"weight\": [[1.0]], "), layer("\"bias\": [1.0], "),
+      layer("\"weight\": [], \"bias\": [], "),
+      layer("\"weight\": [[1.0]], \"bias\": [1.0], ") + ", " + layer("")};
+  for (const std::string &layers : truncated) {
+    EXPECT_THROW(Model::load(writeModel(layers)),
+                 exceptions::json::JSONTypeException)
+        << "Exception did not throw for " << layers;
+  }
+  EXPECT_THROW(
+      Model::load(writeModel(
+          layer("\"weight\": [[1.0], [1.0]], \"bias\": [1.0, 1.0], ") +
+          ", " + layer("\"weight\": [[1.0, 1.0, 1.0]], \"bias\": [1.0], "))),
+      exceptions::eigen::InvalidShapeException);
+}
+
 TEST_F(ModelJsonFile, TestLoadInvalidFormat) {
   Model model = getModel();
   std::vector<std::string> extensions{".test", ".txt", ".pkl"};
@@ -402,18 +564,18 @@ TEST(Model, TestTrainNoValidation) {
 
   // Check loss history
   std::vector<float> lossHistory{0.6935848934440013};
-  ASSERT_EQ(lossHistory.size(), model.getTrainMetrics()["loss"].size())
+  ASSERT_EQ(lossHistory.size(), model.getTrainMetrics().at("loss").size())
       << "Train loss history size does not match.";
   for (int i = 0; i < lossHistory.size(); ++i) {
     ASSERT_TRUE(std::abs(lossHistory[i] -
-                         std::get<float>(model.getTrainMetrics()["loss"][i])) <
+                         model.getTrainMetrics().at("loss")[i][0]) <
                 Eigen::NumTraits<float>::dummy_precision())
         << "Train loss at index " << i
         << " does not match. Expected: " << lossHistory[i]
-        << ", got: " << std::get<float>(model.getTrainMetrics()["loss"][i]);
+        << ", got: " << model.getTrainMetrics().at("loss")[i][0];
   }
   lossHistory = {};
-  ASSERT_EQ(lossHistory.size(), model.getValidationMetrics()["loss"].size())
+  ASSERT_EQ(lossHistory.size(), model.getValidationMetrics().at("loss").size())
       << "Validation loss history size does not match.";
 
   // Check parameters
@@ -444,27 +606,27 @@ TEST(Model, TestTrainWithValidation) {
 
   // Check loss history
   std::vector<float> lossHistory{0.7016281735019937};
-  ASSERT_EQ(lossHistory.size(), model.getTrainMetrics()["loss"].size())
+  ASSERT_EQ(lossHistory.size(), model.getTrainMetrics().at("loss").size())
       << "Train loss history size does not match.";
   for (int i = 0; i < lossHistory.size(); ++i) {
     ASSERT_TRUE(std::abs(lossHistory[i] -
-                         std::get<float>(model.getTrainMetrics()["loss"][i])) <
+                         model.getTrainMetrics().at("loss")[i][0]) <
                 Eigen::NumTraits<float>::dummy_precision())
         << "Train loss at index " << i
         << " does not match. Expected: " << lossHistory[i]
-        << ", got: " << std::get<float>(model.getTrainMetrics()["loss"][i]);
+        << ", got: " << model.getTrainMetrics().at("loss")[i][0];
   }
   lossHistory = {0.6748015101206345};
-  ASSERT_EQ(lossHistory.size(), model.getValidationMetrics()["loss"].size())
+  ASSERT_EQ(lossHistory.size(), model.getValidationMetrics().at("loss").size())
       << "Validation loss history size does not match.";
   for (int i = 0; i < lossHistory.size(); ++i) {
     ASSERT_TRUE(
         std::abs(lossHistory[i] -
-                 std::get<float>(model.getValidationMetrics()["loss"][i])) <
+                 model.getValidationMetrics().at("loss")[i][0]) <
         Eigen::NumTraits<float>::dummy_precision())
         << "Validation loss at index " << i
         << " does not match. Expected: " << lossHistory[i] << ", got: "
-        << std::get<float>(model.getValidationMetrics()["loss"][i]);
+        << model.getValidationMetrics().at("loss")[i][0];
   }
 
   // Check parameters
@@ -496,27 +658,27 @@ TEST(Model, TestTrainWithValidationMultipleEpoch) {
   // Check loss history
   std::vector<float> lossHistory{0.7016281735019942, 0.6905228054354886,
                                  0.6832302979740018};
-  ASSERT_EQ(lossHistory.size(), model.getTrainMetrics()["loss"].size())
+  ASSERT_EQ(lossHistory.size(), model.getTrainMetrics().at("loss").size())
       << "Train loss history size does not match.";
   for (int i = 0; i < lossHistory.size(); ++i) {
     ASSERT_TRUE(std::abs(lossHistory[i] -
-                         std::get<float>(model.getTrainMetrics()["loss"][i])) <
+                         model.getTrainMetrics().at("loss")[i][0]) <
                 Eigen::NumTraits<float>::dummy_precision())
         << "Train loss at index " << i
         << " does not match. Expected: " << lossHistory[i]
-        << ", got: " << std::get<float>(model.getTrainMetrics()["loss"][i]);
+        << ", got: " << model.getTrainMetrics().at("loss")[i][0];
   }
   lossHistory = {0.6748015101206345, 0.6608838491713995, 0.6502008469335846};
-  ASSERT_EQ(lossHistory.size(), model.getValidationMetrics()["loss"].size())
+  ASSERT_EQ(lossHistory.size(), model.getValidationMetrics().at("loss").size())
       << "Validation loss history size does not match.";
   for (int i = 0; i < lossHistory.size(); ++i) {
     ASSERT_TRUE(
         std::abs(lossHistory[i] -
-                 std::get<float>(model.getValidationMetrics()["loss"][i])) <
+                 model.getValidationMetrics().at("loss")[i][0]) <
         Eigen::NumTraits<float>::dummy_precision())
         << "Validation loss at index " << i
         << " does not match. Expected: " << lossHistory[i] << ", got: "
-        << std::get<float>(model.getValidationMetrics()["loss"][i]);
+        << model.getValidationMetrics().at("loss")[i][0];
   }
 
   // Check parameters
@@ -547,27 +709,27 @@ TEST(Model, TestTrainWithValidationLargerBatchSize) {
 
   // Check loss history
   std::vector<float> lossHistory{1.62205669796401};
-  ASSERT_EQ(lossHistory.size(), model.getTrainMetrics()["loss"].size())
+  ASSERT_EQ(lossHistory.size(), model.getTrainMetrics().at("loss").size())
       << "Train loss history size does not match.";
   for (int i = 0; i < lossHistory.size(); ++i) {
     ASSERT_TRUE(std::abs(lossHistory[i] -
-                         std::get<float>(model.getTrainMetrics()["loss"][i])) <
+                         model.getTrainMetrics().at("loss")[i][0]) <
                 Eigen::NumTraits<float>::dummy_precision())
         << "Train loss at index " << i
         << " does not match. Expected: " << lossHistory[i]
-        << ", got: " << std::get<float>(model.getTrainMetrics()["loss"][i]);
+        << ", got: " << model.getTrainMetrics().at("loss")[i][0];
   }
   lossHistory = {2.02241995571785};
-  ASSERT_EQ(lossHistory.size(), model.getValidationMetrics()["loss"].size())
+  ASSERT_EQ(lossHistory.size(), model.getValidationMetrics().at("loss").size())
       << "Validation loss history size does not match.";
   for (int i = 0; i < lossHistory.size(); ++i) {
     ASSERT_TRUE(
         std::abs(lossHistory[i] -
-                 std::get<float>(model.getValidationMetrics()["loss"][i])) <
+                 model.getValidationMetrics().at("loss")[i][0]) <
         Eigen::NumTraits<float>::dummy_precision())
         << "Validation loss at index " << i
         << " does not match. Expected: " << lossHistory[i] << ", got: "
-        << std::get<float>(model.getValidationMetrics()["loss"][i]);
+        << model.getValidationMetrics().at("loss")[i][0];
   }
 
   // Check parameters
@@ -588,9 +750,420 @@ TEST(Model, TestTrainWithValidationLargerBatchSize) {
         << "Bias of layer " << i << " does not match.";
   }
 }
+
+TEST_F(ModelJsonFile, TestTrainWithCheckpoint) {
+  Model model = getModel();
+  MockLoader loader(0.7);
+  Model::TrainKeywordArgs kwargs;
+  kwargs.checkpointPath = this->root / "checkpoint.json";
+  kwargs.checkpointEpochs = 2;
+  model.train(loader, 1e-4, 1, 3, kwargs);
+
+  auto [checkpointModel, state] = checkpoint::load(kwargs.checkpointPath);
+  EXPECT_EQ(model, checkpointModel);
+  EXPECT_EQ(3, checkpointModel.getTotalEpochs());
+  EXPECT_EQ(4, state.epoch);
+  EXPECT_EQ(3, state.epochs);
+  EXPECT_DOUBLE_EQ(1e-4, state.learningRate);
+}
+
+TEST_F(ModelJsonFile, TestTrainResumeFromCheckpoint) {
+  Model expected = getModel();
+  MockLoader loader(0.7);
+  expected.train(loader, 1e-4, 1, 3);
+
+  Model::TrainKeywordArgs kwargs;
+  kwargs.checkpointPath = this->root / "checkpoint.json";
+  Model interrupted = getModel();
+  interrupted.train(loader, 1e-4, 1, 2, kwargs);
+  auto [model, state] = checkpoint::load(kwargs.checkpointPath);
+  kwargs.start = state;
+  model.train(loader, state.learningRate, 1, 3, kwargs);
+
+  EXPECT_EQ(expected, model);
+  EXPECT_EQ(expected.getTotalEpochs(), model.getTotalEpochs());
+  EXPECT_EQ(expected.getTrainMetrics(), model.getTrainMetrics());
+  EXPECT_EQ(expected.getValidationMetrics(), model.getValidationMetrics());
+}
+
+TEST_F(ModelJsonFile, TestTrainResumeMidEpochFromCheckpoint) {
+  Model expected = getModel();
+  MockLoader loader(0.7);
+  expected.train(loader, 1e-4, 1, 2);
+
+  Model::TrainKeywordArgs kwargs;
+  kwargs.checkpointPath = this->root / "checkpoint.json";
+  kwargs.checkpointMinutes = 1e-12;
+  Model interrupted = getModel();
+  InterruptedLoader interruptedLoader(0.7, 4);
+  EXPECT_THROW(interrupted.train(interruptedLoader, 1e-4, 1, 2, kwargs),
+               std::runtime_error);
+
+  auto [model, state] = checkpoint::load(kwargs.checkpointPath);
+  EXPECT_EQ(1, state.epoch);
+  EXPECT_EQ(4, state.batch);
+  EXPECT_EQ(0, model.getTotalEpochs());
+  kwargs.start = state;
+  model.train(loader, state.learningRate, 1, 2, kwargs);
+
+  EXPECT_EQ(expected, model);
+  EXPECT_EQ(expected.getTotalEpochs(), model.getTotalEpochs());
+  EXPECT_EQ(expected.getTrainMetrics(), model.getTrainMetrics());
+  EXPECT_EQ(expected.getValidationMetrics(), model.getValidationMetrics());
+}
+
+TEST(Model, TestTrainWithTimings) {
+  Model expected = getModel();
+  MockLoader loader(0.7);
+  expected.train(loader, 1e-4, 1, 2);
+
+  Model model = getModel();
+  Model::TrainKeywordArgs kwargs;
+  kwargs.timings = true;
+  model.train(loader, 1e-4, 1, 2, kwargs);
+
+  EXPECT_EQ(expected, model);
+  EXPECT_EQ(expected.getTrainMetrics(), model.getTrainMetrics());
+
+  utils::timer::StageTimer timer;
+  kwargs.timer = &timer;
+  model.train(loader, 1e-4, 1, 1, kwargs);
+  ASSERT_FALSE(timer.getTimings().empty());
+  EXPECT_EQ("Load batch", timer.getTimings().front().stage);
+}
+
+TEST(Model, TestTrainWithMemoryUsage) {
+  Model expected = getModel();
+  MockLoader loader(0.7);
+  expected.train(loader, 1e-4, 1, 2);
+
+  Model model = getModel();
+  Model::TrainKeywordArgs kwargs;
+  kwargs.memoryUsage = true;
+  model.train(loader, 1e-4, 1, 2, kwargs);
+
+  EXPECT_EQ(expected, model);
+  EXPECT_EQ(expected.getTrainMetrics(), model.getTrainMetrics());
+}
+
+TEST(Model, TestTrainWithSampledValidation) {
+  Model model = getModel();
+  SampledValidationLoader loader(0.7);
+  Model::TrainKeywordArgs kwargs;
+  kwargs.validationSamples = 2;
+  kwargs.fullValidationEpochs = 2;
+  model.train(loader, 1e-4, 1, 5, kwargs);
+
+  std::vector<int> expected{2, 0, 2, 0, 0};
+  EXPECT_EQ(expected, loader.samples);
+  EXPECT_EQ(5, model.getValidationMetrics().at("loss").size());
+}
+
+TEST(Model, TestTrainWithLearningRateSchedule) {
+  Model expected = getModel();
+  MockLoader loader(0.7);
+  expected.train(loader, 1e-4, 1, 2);
+
+  // Annealing to the learning rate keeps it constant
+  Model model = getModel();
+  Model::TrainKeywordArgs kwargs;
+  kwargs.learningRateSchedule.schedule = lr_scheduler::Schedule::COSINE;
+  kwargs.learningRateSchedule.minLearningRate = 1e-4;
+  model.train(loader, 1e-4, 1, 2, kwargs);
+  EXPECT_EQ(expected, model);
+
+  Model warmedUp = getModel();
+  kwargs.learningRateSchedule.warmupEpochs = 1;
+  warmedUp.train(loader, 1e-4, 1, 2, kwargs);
+  EXPECT_NE(expected, warmedUp);
+}
+
+TEST(Model, TestTrainWithEarlyStopping) {
+  Model model = getModel();
+  MockLoader loader(0.7);
+  Model::TrainKeywordArgs kwargs;
+  kwargs.earlyStoppingPatience = 2;
+  model.train(loader, 0, 1, 10, kwargs);
+
+  // The loss does not change without learning, so only the first epoch
+  // improves
+  EXPECT_EQ(3, model.getTotalEpochs());
+  EXPECT_EQ(3, model.getValidationMetrics().at("loss").size());
+}
+
+TEST(Model, TestTrainWithEarlyStoppingRestoresBestWeights) {
+  Model expected = getModel();
+  MockLoader loader(0.7);
+  expected.train(loader, 1e-4, 1, 1);
+
+  Model model = getModel();
+  Model::TrainKeywordArgs kwargs;
+  kwargs.earlyStoppingPatience = 1;
+  kwargs.earlyStoppingMinDelta = 1e9;
+  kwargs.restoreBestWeights = true;
+  model.train(loader, 1e-4, 1, 5, kwargs);
+
+  EXPECT_EQ(2, model.getTotalEpochs());
+  for (int i = 0; i < expected.getLayers().size(); ++i) {
+    EXPECT_EQ(expected.getLayers()[i].getWeight(),
+              model.getLayers()[i].getWeight())
+        << "Weights of layer " << i << " do not match.";
+    EXPECT_EQ(expected.getLayers()[i].getBias(),
+              model.getLayers()[i].getBias())
+        << "Bias of layer " << i << " does not match.";
+  }
+}
+
+TEST(Model, TestTrainWithoutStoppingRestoresBestWeights) {
+  Model expected = getModel();
+  MockLoader loader(0.7);
+  expected.train(loader, 1e-4, 1, 1);
+
+  // Only the first epoch improves, but patience never runs out
+  Model model = getModel();
+  Model::TrainKeywordArgs kwargs;
+  kwargs.earlyStoppingPatience = 10;
+  kwargs.earlyStoppingMinDelta = 1e9;
+  kwargs.restoreBestWeights = true;
+  model.train(loader, 1e-4, 1, 3, kwargs);
+
+  EXPECT_EQ(3, model.getTotalEpochs());
+  EXPECT_EQ(expected, model);
+}
+
+TEST(Model, TestTrainWithEarlyStoppingOnFullValidations) {
+  Model model = getModel();
+  SampledValidationLoader loader(0.7);
+  Model::TrainKeywordArgs kwargs;
+  kwargs.validationSamples = 2;
+  kwargs.fullValidationEpochs = 2;
+  kwargs.earlyStoppingPatience = 1;
+  kwargs.earlyStoppingMinDelta = 1e9;
+  model.train(loader, 1e-4, 1, 10, kwargs);
+
+  // The sampled epochs are not compared, so training stops after the second
+  // full validation
+  std::vector<int> expected{2, 0, 2, 0};
+  EXPECT_EQ(expected, loader.samples);
+  EXPECT_EQ(4, model.getTotalEpochs());
+}
+
+TEST(Model, TestTrainWithEarlyStoppingUntrackedMetric) {
+  Model model = getModel();
+  MockLoader loader(0.7);
+  Model::TrainKeywordArgs kwargs;
+  kwargs.earlyStoppingPatience = 1;
+  kwargs.earlyStoppingMetric = "accuracy";
+  EXPECT_THROW(model.train(loader, 1e-4, 1, 2, kwargs),
+               exceptions::early_stopping::UntrackedMetricException);
+  EXPECT_EQ(0, model.getTotalEpochs());
+}
+
+TEST_F(ModelJsonFile, TestTrainWithEarlyStoppingCheckpoint) {
+  Model model = getModel();
+  MockLoader loader(0.7);
+  Model::TrainKeywordArgs kwargs;
+  kwargs.checkpointPath = this->root / "checkpoint.json";
+  kwargs.checkpointEpochs = 0;
+  kwargs.earlyStoppingPatience = 1;
+  model.train(loader, 0, 1, 10, kwargs);
+
+  auto [checkpointModel, state] = checkpoint::load(kwargs.checkpointPath);
+  EXPECT_EQ(2, checkpointModel.getTotalEpochs());
+  EXPECT_EQ(11, state.epoch);
+}
+
+TEST_F(ModelMetricsLog, TestTrainWithMetricsLog) {
+  Model expected = getModel();
+  MockLoader loader(0.7);
+  expected.train(loader, 1e-4, 1, 2);
+
+  Model model = getModel();
+  Model::TrainKeywordArgs kwargs;
+  kwargs.metricsLogPath = this->root / "metrics.jsonl";
+  kwargs.metricsLogBatches = 2;
+  model.train(loader, 1e-4, 1, 2, kwargs);
+  EXPECT_EQ(expected, model);
+
+  // Each epoch logs the partial train records, the train record and the
+  // validation record
+  int batches = loader("train", 1)->size();
+  std::vector<json> records;
+  std::ifstream file(kwargs.metricsLogPath);
+  for (std::string line; std::getline(file, line);) {
+    records.push_back(json::parse(line));
+  }
+  ASSERT_EQ(2 * ((batches - 1) / 2 + 2), records.size());
+  EXPECT_EQ(2, records[0]["batch"]);
+  EXPECT_EQ("train", records[(batches - 1) / 2]["split"]);
+  EXPECT_EQ(batches, records[(batches - 1) / 2]["batch"]);
+  EXPECT_FLOAT_EQ(model.getTrainMetrics().at("loss")[0][0],
+                  records[(batches - 1) / 2]["metrics"]["loss"]);
+  EXPECT_EQ("validation", records[(batches - 1) / 2 + 1]["split"]);
+  EXPECT_EQ(2, records.back()["epoch"]);
+}
+
+TEST(Model, TestMemory) {
+  Model model = getModel();
+  EXPECT_EQ((12 + 3 + 6 + 2) * sizeof(double), model.getParameterSize());
+  EXPECT_EQ(0, model.getCacheSize());
+  EXPECT_EQ(0, model.getMetricHistorySize());
+
+  MockLoader loader(0.7);
+  model.train(loader, 1e-4, 1, 1);
+  EXPECT_GT(model.getCacheSize(), 0);
+  // Each epoch stores the loss of the train and validation metrics.
+  EXPECT_EQ(2 * sizeof(float), model.getMetricHistorySize());
+}
+
+TEST(Model, TestTrainWithAllocationCounts) {
+  Model expected = getModel();
+  MockLoader loader(0.7);
+  expected.train(loader, 1e-4, 1, 2);
+
+  Model model = getModel();
+  Model::TrainKeywordArgs kwargs;
+  kwargs.allocationCounts = true;
+  model.train(loader, 1e-4, 1, 2, kwargs);
+
+  EXPECT_EQ(expected, model);
+  EXPECT_EQ(expected.getTrainMetrics(), model.getTrainMetrics());
+}
+
+TEST(Model, TestTrainStepAllocations) {
+  if (!utils::allocations::isEnabled()) {
+    GTEST_SKIP() << "Allocations are only counted with COUNT_ALLOCATIONS.";
+  }
+
+  Model model = getModel();
+  auto [data, labels] = getData();
+  Eigen::MatrixXi confusionMatrix = metrics::getNewConfusionMatrix(2);
+  model.trainStep(data, labels, 1e-4, confusionMatrix);
+
+  // Lower the bound as allocations are removed from the training step.
+  utils::allocations::ScopedCounter counter;
+  model.trainStep(data, labels, 1e-4, confusionMatrix);
+  EXPECT_LE(counter.get().allocations, 44);
+}
+
+TEST(Model, TestTestStepAllocations) {
+  if (!utils::allocations::isEnabled()) {
+    GTEST_SKIP() << "Allocations are only counted with COUNT_ALLOCATIONS.";
+  }
+
+  Model model = getModel();
+  model.setEval(true);
+  auto [data, labels] = getData();
+  Eigen::MatrixXi confusionMatrix = metrics::getNewConfusionMatrix(2);
+  model.getLossWithConfusionMatrix(data, confusionMatrix, labels);
+
+  // Lower the bound as allocations are removed from the test step.
+  utils::allocations::ScopedCounter counter;
+  model.getLossWithConfusionMatrix(data, confusionMatrix, labels);
+  EXPECT_LE(counter.get().allocations, 10);
+}
+
+TEST_F(ModelJsonFile, TestTrainWithTrace) {
+  Model model = getModel();
+  MockLoader loader(0.7);
+  Model::TrainKeywordArgs kwargs;
+  kwargs.checkpointPath = this->root / "checkpoint.json";
+  utils::trace::start();
+  model.train(loader, 1e-4, 1, 1, kwargs);
+  utils::trace::stop();
+
+  json trace = utils::trace::toJson();
+  std::unordered_set<std::string> names;
+  for (const json &event : trace["traceEvents"]) {
+    names.insert(event["name"].get<std::string>());
+  }
+  for (const std::string &name :
+       {"Forward layer 1", "Forward layer 2", "Loss", "Metrics",
+        "Backward layer 1", "Backward layer 2", "Update layer 1",
+        "Update layer 2", "Load batch", "Snapshot checkpoint",
+        "Write checkpoint"}) {
+    EXPECT_TRUE(names.contains(name)) << name << " was not traced.";
+  }
+}
 #pragma endregion Train
 
 #pragma region Test
+TEST(Model, TestTestWithWorkers) {
+  MockLoader loader(1);
+  for (int batchSize : {1, 2, 5}) {
+    Model model = getModel();
+    auto [expectedLoss, expectedMatrix] = model.test(loader("train", batchSize));
+    for (int workers : {2, 3, 8, 100}) {
+      Model::TestKeywordArgs kwargs;
+      kwargs.workers = workers;
+      auto [loss, confusionMatrix] =
+          model.test(loader("train", batchSize), "", kwargs);
+      EXPECT_EQ(expectedLoss, loss)
+          << batchSize << " batch size, " << workers << " workers.";
+      EXPECT_EQ(expectedMatrix, confusionMatrix)
+          << batchSize << " batch size, " << workers << " workers.";
+    }
+  }
+}
+
+TEST(Model, TestTestWithWorkersRethrows) {
+  Model model = getModel();
+  InterruptedLoader loader(1, 3);
+  Model::TestKeywordArgs kwargs;
+  kwargs.workers = 4;
+  EXPECT_THROW(model.test(loader("train", 1), "", kwargs), std::runtime_error);
+  EXPECT_FALSE(model.getEval());
+}
+
+TEST(Model, TestTestWithStreamingMetrics) {
+  MockLoader loader(1);
+  Model model = getModel();
+  metrics::StreamingMetrics expected({"top_1_accuracy", "calibration_error"});
+  auto [_, confusionMatrix] = model.test(
+      loader("train", 2), "", Model::TestKeywordArgs{1, nullptr, &expected});
+  EXPECT_FLOAT_EQ(metrics::accuracy(confusionMatrix),
+                  std::get<float>(expected.compute("top_1_accuracy")));
+
+  metrics::StreamingMetrics streaming({"top_1_accuracy", "calibration_error"});
+  model.test(loader("train", 2), "",
+             Model::TestKeywordArgs{3, nullptr, &streaming});
+  for (const std::string &metric : {"top_1_accuracy", "calibration_error"}) {
+    EXPECT_FLOAT_EQ(std::get<float>(expected.compute(metric)),
+                    std::get<float>(streaming.compute(metric)))
+        << metric;
+  }
+}
+
+TEST(Model, TestTrainWithStreamingMetrics) {
+  Model model = getModel();
+  model.setTrainMetrics(Model::metricTypesToHistory(
+      {"accuracy", "top_1_accuracy", "confidence_histogram"}));
+  model.setValidationMetrics(
+      Model::metricTypesToHistory({"accuracy", "top_1_accuracy"}));
+  MockLoader loader(0.7);
+  model.train(loader, 1e-4, 2, 2);
+
+  for (const auto *metrics :
+       {&model.getTrainMetrics(), &model.getValidationMetrics()}) {
+    const metricHistoryValue &accuracy = metrics->at("accuracy"),
+                             &topOne = metrics->at("top_1_accuracy");
+    ASSERT_EQ(2, topOne.size());
+    for (int i = 0; i < accuracy.size(); ++i) {
+      EXPECT_FLOAT_EQ(accuracy[i][0], topOne[i][0]);
+    }
+  }
+  EXPECT_EQ(metrics::CONFIDENCE_BINS,
+            model.getTrainMetrics().at("confidence_histogram").getWidth());
+}
+
+TEST(Model, TestCalculateMetricsWithoutStreamingMetrics) {
+  std::unordered_map<std::string, metricHistoryValue> history =
+      Model::metricTypesToHistory({"top_1_accuracy"});
+  EXPECT_THROW(
+      Model::calculateMetrics(history, metrics::getNewConfusionMatrix(2), 0),
+      exceptions::model::MissingStreamingMetricException);
+}
+
 TEST(Model, TestTestWithNoClasses) {
   Model model(getLayers(), getLoss());
   MockLoader loader(1);
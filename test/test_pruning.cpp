@@ -0,0 +1,180 @@
+#include "pruning.hpp"
+#include "activation_functions.hpp"
+#include "cross_entropy_loss.hpp"
+#include "exceptions/pruning.hpp"
+#include "image_loader.hpp"
+#include "linear.hpp"
+#include "model.hpp"
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pruning;
+
+namespace test_pruning {
+#pragma region Fixtures
+/*
+  Get a model with a hidden layer of 3 units, where the second unit has no
+  outgoing weights and the third unit is never active on the data.
+*/
+model::Model getModel() {
+  std::vector<linear::Linear> layers{
+      linear::Linear(Eigen::MatrixXd{{0.5, -0.25, 0.75, 0.1},
+                                     {-0.5, 0.25, 0.5, -0.2},
+                                     {0.3, 0.6, -0.9, 0.4}},
+                     Eigen::VectorXd{{0.1, -0.1, -100}}, "ReLU"),
+      linear::Linear(Eigen::MatrixXd{{1, 0, 0.25}, {-0.75, 0, 1}},
+                     Eigen::VectorXd{{0.05, -0.05}})};
+  model::Model::KeywordArgs kwargs;
+  kwargs.classes = {"0", "1"};
+  return model::Model(layers, loss::CrossEntropyLoss(), kwargs);
+}
+
+std::shared_ptr<loader::DatasetBatcher> getBatcher() {
+  Eigen::MatrixXd X{{4, -3, 2, 4}, {6, -3, 6, 1},  {5, 9, 8, 3},
+                    {8, -10, 8, -7}, {0, 3, 7, 5}, {7, -6, 8, 8}};
+  return std::make_shared<loader::InMemoryDatasetBatcher>(
+      std::make_shared<const loader::minibatch>(
+          X, std::vector<int>{0, 1, 1, 1, 1, 0}),
+      4, loader::DatasetBatcher::KeywordArgs{.shuffle = false});
+}
+
+/*
+  Get the widths of the model's layers, starting with its inputs.
+*/
+std::vector<int> getWidths(const model::Model &model) {
+  std::vector<linear::Linear> layers = model.getLayers();
+  std::vector<int> widths{layers.front().inChannels};
+  for (const linear::Linear &layer : layers) {
+    widths.push_back(layer.outChannels);
+  }
+  return widths;
+}
+
+/*
+  Check that the models produce the same logits on the data.
+*/
+void expectSameLogits(model::Model &expected, model::Model &result) {
+  expected.setEval(true);
+  result.setEval(true);
+  std::shared_ptr<loader::DatasetBatcher> batcher = getBatcher();
+  for (const auto &[data, _] : *batcher) {
+    EXPECT_TRUE(expected.forward(data).isApprox(result.forward(data)))
+        << "Expected: " << expected.forward(data)
+        << ", Got: " << result.forward(data);
+  }
+}
+#pragma endregion Fixtures
+
+#pragma region Tests
+TEST(Pruning, TestCriterionFromString) {
+  EXPECT_EQ(Criterion::WEIGHT, criterionFromString("weight"));
+  EXPECT_EQ(Criterion::ACTIVATION, criterionFromString("activation"));
+  EXPECT_THROW(criterionFromString("gradient"),
+               exceptions::pruning::InvalidCriterionException);
+}
+
+#pragma region Score
+TEST(Pruning, TestScoreUnitsWithWeight) {
+  model::Model model = getModel();
+  std::vector<linear::Linear> layers = model.getLayers();
+  Eigen::VectorXd expected =
+      layers[0].getWeight().rowwise().norm().cwiseProduct(
+          layers[1].getWeight().colwise().norm().transpose());
+  std::vector<Eigen::VectorXd> scores = scoreUnits(model, nullptr, {});
+  ASSERT_EQ(1, scores.size());
+  EXPECT_TRUE(expected.isApprox(scores[0]));
+  EXPECT_EQ(0, scores[0][1]);
+}
+
+TEST(Pruning, TestScoreUnitsWithActivation) {
+  std::vector<Eigen::VectorXd> scores =
+      scoreUnits(getModel(), getBatcher(), {Criterion::ACTIVATION});
+  ASSERT_EQ(1, scores.size());
+  EXPECT_GT(scores[0][0], 0);
+  EXPECT_EQ(0, scores[0][1]);
+  EXPECT_EQ(0, scores[0][2]);
+}
+
+TEST(Pruning, TestScoreUnitsWithInvalidCalibrationBatches) {
+  EXPECT_THROW(scoreUnits(getModel(), getBatcher(), {Criterion::ACTIVATION, 0}),
+               exceptions::pruning::InvalidCalibrationBatchesException);
+}
+#pragma endregion Score
+
+#pragma region Prune
+TEST(Pruning, TestPruneWithWeight) {
+  model::Model model = getModel();
+  model::Model pruned = prune(model, 1.0 / 3, nullptr);
+  EXPECT_EQ(std::vector<int>({4, 2, 2}), getWidths(pruned));
+
+  // The unit without outgoing weights is removed
+  std::vector<linear::Linear> layers = pruned.getLayers();
+  EXPECT_EQ(Eigen::MatrixXd({{0.5, -0.25, 0.75, 0.1}, {0.3, 0.6, -0.9, 0.4}}),
+            layers[0].getWeight());
+  EXPECT_EQ(Eigen::VectorXd({{0.1, -100}}), layers[0].getBias());
+  EXPECT_EQ(Eigen::MatrixXd({{1, 0.25}, {-0.75, 1}}), layers[1].getWeight());
+  EXPECT_EQ(Eigen::VectorXd({{0.05, -0.05}}), layers[1].getBias());
+  EXPECT_EQ("ReLU", layers[0].getActivation()->getName());
+  EXPECT_EQ(model.getClasses(), pruned.getClasses());
+  expectSameLogits(model, pruned);
+}
+
+TEST(Pruning, TestPruneWithActivation) {
+  model::Model model = getModel();
+  model::Model pruned =
+      prune(model, 2.0 / 3, getBatcher(), {Criterion::ACTIVATION});
+  EXPECT_EQ(std::vector<int>({4, 1, 2}), getWidths(pruned));
+  expectSameLogits(model, pruned);
+
+  // The weight criterion keeps the inactive unit instead
+  model::Model weightPruned = prune(model, 2.0 / 3, nullptr);
+  EXPECT_EQ(-100, weightPruned.getLayers()[0].getBias()[0]);
+}
+
+TEST(Pruning, TestPruneDeepModel) {
+  std::vector<linear::Linear> layers{linear::Linear(6, 5, "ReLU"),
+                                     linear::Linear(5, 4, "ReLU"),
+                                     linear::Linear(4, 3)};
+  model::Model model(layers, loss::CrossEntropyLoss());
+  model::Model pruned = prune(model, 0.5, nullptr);
+  EXPECT_EQ(std::vector<int>({6, 3, 2, 3}), getWidths(pruned));
+  EXPECT_EQ(3, pruned.forward(Eigen::MatrixXd::Ones(2, 6)).cols());
+
+  EXPECT_EQ(std::vector<int>({6, 1, 1, 3}),
+            getWidths(prune(model, 0.99, nullptr)));
+  EXPECT_EQ(std::vector<int>({6, 5, 4, 3}),
+            getWidths(prune(model, 0, nullptr)));
+}
+
+TEST(Pruning, TestPruneSingleLayerModel) {
+  model::Model model({linear::Linear(4, 2)}, loss::CrossEntropyLoss());
+  EXPECT_EQ(std::vector<int>({4, 2}), getWidths(prune(model, 0.5, nullptr)));
+}
+
+TEST(Pruning, TestPruneWithInvalidSparsity) {
+  for (double sparsity : {-0.1, 1.0, 1.5}) {
+    EXPECT_THROW(prune(getModel(), sparsity, nullptr),
+                 exceptions::pruning::InvalidSparsityException)
+        << sparsity;
+  }
+}
+#pragma endregion Prune
+
+#pragma region Report
+TEST(Pruning, TestCompare) {
+  const model::Model model = getModel(),
+                     pruned = prune(model, 1.0 / 3, nullptr);
+  Report report = compare(model, pruned, getBatcher());
+  EXPECT_FLOAT_EQ(report.accuracy, report.prunedAccuracy);
+  EXPECT_FLOAT_EQ(1, report.agreement);
+  EXPECT_EQ(std::vector<int>({4, 3, 2}), report.widths);
+  EXPECT_EQ(std::vector<int>({4, 2, 2}), report.prunedWidths);
+  EXPECT_EQ(model.getParameterSize(), report.size);
+  EXPECT_LT(report.prunedSize, report.size);
+}
+#pragma endregion Report
+#pragma endregion Tests
+} // namespace test_pruning
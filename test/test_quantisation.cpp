@@ -0,0 +1,219 @@
+#include "quantisation.hpp"
+#include "cross_entropy_loss.hpp"
+#include "exceptions/activation_functions.hpp"
+#include "exceptions/eigen.hpp"
+#include "exceptions/json.hpp"
+#include "exceptions/quantisation.hpp"
+#include "fixtures.hpp"
+#include "image_loader.hpp"
+#include "linear.hpp"
+#include "model.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+using namespace quantisation;
+using json = nlohmann::json;
+
+namespace test_quantisation {
+#pragma region Fixtures
+linear::Linear getLayer(const std::string &activation = "NoActivation") {
+  return linear::Linear(Eigen::MatrixXd{{0.5, -1, 0.25}, {2, 1, -0.5}},
+                        Eigen::VectorXd{{0.1, -0.2}}, activation);
+}
+
+model::Model getModel() {
+  std::vector<linear::Linear> layers{
+      linear::Linear(Eigen::MatrixXd{{0.5, -0.25, 0.75, 0.1},
+                                     {-0.5, 0.25, 0.5, -0.2},
+                                     {0.3, 0.6, -0.9, 0.4}},
+                     Eigen::VectorXd{{0.1, -0.1, 0.2}}, "ReLU"),
+      linear::Linear(Eigen::MatrixXd{{1, -0.5, 0.25}, {-0.75, 0.5, 1}},
+                     Eigen::VectorXd{{0.05, -0.05}})};
+  model::Model::KeywordArgs kwargs;
+  kwargs.classes = {"0", "1"};
+  return model::Model(layers, loss::CrossEntropyLoss(), kwargs);
+}
+
+std::pair<Eigen::MatrixXd, std::vector<int>> getData() {
+  return std::make_pair(Eigen::MatrixXd{{4, -3, 2, 4},
+                                        {6, -3, 6, 1},
+                                        {5, 9, 8, 3},
+                                        {8, -10, 8, -7},
+                                        {0, 3, 7, 5},
+                                        {7, -6, 8, 8},
+                                        {1, -10, -7, 5},
+                                        {-6, 5, 4, -9}},
+                        std::vector<int>{0, 1, 1, 1, 1, 0, 1, 1});
+}
+
+struct MockDatasetBatcher : public loader::DatasetBatcher {
+  Eigen::MatrixXd X;
+  std::vector<int> y;
+  int batchSize;
+
+  MockDatasetBatcher(const Eigen::MatrixXd &X, const std::vector<int> &y,
+                     int batchSize)
+      : X(X), y(y), batchSize(batchSize), loader::DatasetBatcher("", {}, {}, {},
+                                                                 batchSize){};
+
+  int size() const override {
+    return (this->X.rows() + this->batchSize - 1) / this->batchSize;
+  }
+
+  loader::minibatch operator[](int i) const override {
+    int start = i * this->batchSize,
+        end = std::min((int)this->y.size(), (i + 1) * this->batchSize);
+    return std::make_pair(this->X.middleRows(start, end - start),
+                          std::vector<int>(this->y.begin() + start,
+                                           this->y.begin() + end));
+  };
+};
+
+std::shared_ptr<loader::DatasetBatcher> getBatcher() {
+  auto [X, y] = getData();
+  return std::make_shared<MockDatasetBatcher>(X, y, 3);
+}
+
+class QuantisedModelFile : public test_filesystem::BaseFileSystemFixture {};
+#pragma endregion Fixtures
+
+#pragma region Tests
+#pragma region Quantised linear
+TEST(QuantisedLinear, TestQuantise) {
+  linear::Linear layer = getLayer();
+  QuantisedLinear quantised = QuantisedLinear::quantise(layer, 0.5);
+
+  Eigen::VectorXf scales{{1 / 127.0f, 2 / 127.0f}};
+  ASSERT_TRUE(scales.isApprox(quantised.getWeightScales()))
+      << "Weight scales do not match.";
+  EXPECT_EQ(127, quantised.getWeight().row(0).cwiseAbs().maxCoeff());
+  EXPECT_EQ(127, quantised.getWeight().row(1).cwiseAbs().maxCoeff());
+
+  Eigen::MatrixXd dequantised =
+      quantised.getWeight().cast<double>().array().colwise() *
+      scales.cast<double>().array();
+  EXPECT_LE((dequantised - layer.getWeight()).cwiseAbs().maxCoeff(),
+            1 / 127.0)
+      << "Dequantised weight is outside the rounding error.";
+  EXPECT_FLOAT_EQ(0.5, quantised.getInputScale());
+  EXPECT_EQ("NoActivation", quantised.getActivation());
+}
+
+TEST(QuantisedLinear, TestInitWithMismatchedParameters) {
+  EXPECT_THROW(QuantisedLinear(MatrixXi8::Zero(2, 3), Eigen::VectorXf(3),
+                               Eigen::VectorXf(2), 1),
+               exceptions::eigen::InvalidShapeException)
+      << "Mismatched weight scales did not throw.";
+  EXPECT_THROW(QuantisedLinear(MatrixXi8::Zero(2, 3), Eigen::VectorXf(2),
+                               Eigen::VectorXf(3), 1),
+               exceptions::eigen::InvalidShapeException)
+      << "Mismatched bias did not throw.";
+  EXPECT_THROW(QuantisedLinear(MatrixXi8::Zero(2, 3), Eigen::VectorXf(2),
+                               Eigen::VectorXf(2), 1, "Sigmoid"),
+               exceptions::activation::InvalidActivationException)
+      << "Invalid activation did not throw.";
+}
+
+TEST(QuantisedLinear, TestForward) {
+  for (const std::string &activation : {"NoActivation", "ReLU"}) {
+    linear::Linear layer = getLayer(activation);
+    Eigen::MatrixXd input{{1, -2, 0.5}, {-0.25, 0.75, -1}, {2, 1, 1.5},
+                          {0, 0, 0},    {-2, 2, -2}};
+    QuantisedLinear quantised = QuantisedLinear::quantise(layer, 2 / 127.0f);
+
+    Eigen::MatrixXd expected = layer(input),
+                    result = quantised.forward(input.cast<float>())
+                                 .cast<double>();
+    ASSERT_EQ(expected.rows(), result.rows());
+    ASSERT_EQ(expected.cols(), result.cols());
+    EXPECT_LE((expected - result).cwiseAbs().maxCoeff(), 0.05)
+        << "Output does not match with " << activation << ".";
+    if (activation == "ReLU") {
+      EXPECT_GE(result.minCoeff(), 0);
+    }
+  }
+}
+
+TEST(QuantisedLinear, TestForwardWithInvalidShape) {
+  QuantisedLinear quantised = QuantisedLinear::quantise(getLayer(), 1);
+  EXPECT_THROW(quantised.forward(RowMatrixXf::Zero(2, 4)),
+               exceptions::eigen::InvalidShapeException);
+}
+
+TEST(QuantisedLinear, TestJsonRoundTrip) {
+  QuantisedLinear expected = QuantisedLinear::quantise(getLayer("ReLU"), 0.25);
+  json values = expected.toJson();
+  EXPECT_EQ("QuantisedLinear", values["class"]);
+  EXPECT_EQ(expected, QuantisedLinear::fromJson(values));
+}
+
+TEST(QuantisedLinear, TestFromJsonWithInvalidWeight) {
+  json values = QuantisedLinear::quantise(getLayer(), 0.25).toJson();
+  for (double weight : {128.0, -128.0, 0.5}) {
+    values["weight"][0][0] = weight;
+    EXPECT_THROW(QuantisedLinear::fromJson(values),
+                 exceptions::json::JSONTypeException)
+        << "Exception did not throw for " << weight;
+  }
+}
+#pragma endregion Quantised linear
+
+#pragma region Quantised model
+TEST(QuantisedModel, TestQuantise) {
+  model::Model model = getModel();
+  QuantisedModel quantised = QuantisedModel::quantise(model, getBatcher(), 3);
+
+  std::vector<QuantisedLinear> layers = quantised.getLayers();
+  ASSERT_EQ(2, layers.size());
+  EXPECT_FLOAT_EQ(10 / 127.0f, layers[0].getInputScale())
+      << "Input scale was not calibrated on the data.";
+  EXPECT_EQ(model.getClasses(), quantised.getClasses());
+
+  Eigen::MatrixXd input = getData().first,
+                  expected = model.forward(input), result = quantised(input);
+  EXPECT_LE((expected - result).cwiseAbs().maxCoeff(), 0.1)
+      << "Logits do not match.";
+  EXPECT_EQ(model.predict(input), quantised.predict(input));
+}
+
+TEST(QuantisedModel, TestQuantiseWithInvalidCalibrationBatches) {
+  EXPECT_THROW(QuantisedModel::quantise(getModel(), getBatcher(), 0),
+               exceptions::quantisation::InvalidCalibrationBatchesException);
+}
+
+TEST(QuantisedModel, TestSize) {
+  QuantisedModel quantised =
+      QuantisedModel::quantise(getModel(), getBatcher(), 1);
+  // int8 weights, and float scales, biases and input scale per layer.
+  EXPECT_EQ(12 + (3 + 3 + 1) * 4 + 6 + (2 + 2 + 1) * 4, quantised.getSize());
+}
+
+TEST_F(QuantisedModelFile, TestSaveAndLoad) {
+  QuantisedModel expected =
+      QuantisedModel::quantise(getModel(), getBatcher(), 3);
+  std::filesystem::path path = this->root / "quantised.json";
+  expected.save(path);
+  EXPECT_EQ(expected, QuantisedModel::load(path));
+}
+
+TEST(QuantisedModel, TestCompare) {
+  model::Model model = getModel();
+  QuantisedModel quantised = QuantisedModel::quantise(model, getBatcher(), 3);
+  Report report = compare(model, quantised, getBatcher());
+
+  EXPECT_FLOAT_EQ(report.accuracy, report.quantisedAccuracy);
+  EXPECT_FLOAT_EQ(1, report.agreement);
+  EXPECT_LE(report.maxLogitError, 0.1);
+  EXPECT_EQ((12 + 3 + 6 + 2) * sizeof(double), report.size);
+  EXPECT_EQ(quantised.getSize(), report.quantisedSize);
+}
+#pragma endregion Quantised model
+#pragma endregion Tests
+} // namespace test_quantisation
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "exceptions/metrics.hpp"
+#include "streaming_metrics.hpp"
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+#include <memory>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace metrics;
+
+namespace test_streaming_metrics {
+#pragma region Fixtures
+Eigen::MatrixXd getLogits() {
+  return Eigen::MatrixXd{{1, 3, 2}, {3, 2, 1}, {1, 2, 3}};
+}
+
+std::vector<int> getLabels() { return {2, 2, 0}; }
+#pragma endregion Fixtures
+
+#pragma region Tests
+#pragma region Top k accuracy
+TEST(StreamingMetrics, TestTopKAccuracy) {
+  std::vector<float> expected{0, 1.0f / 3, 1, 1};
+  for (int k = 1; k <= expected.size(); ++k) {
+    TopKAccuracy accumulator(k);
+    accumulator.update(getLogits(), getLabels());
+    EXPECT_FLOAT_EQ(expected[k - 1], std::get<float>(accumulator.compute()))
+        << "Top " << k << " accuracy does not match.";
+  }
+}
+
+TEST(StreamingMetrics, TestTopKAccuracyTies) {
+  TopKAccuracy accumulator(1);
+  accumulator.update(Eigen::MatrixXd{{1, 1}, {1, 1}}, std::vector<int>{0, 1});
+  EXPECT_FLOAT_EQ(0.5, std::get<float>(accumulator.compute()));
+}
+
+TEST(StreamingMetrics, TestTopKAccuracyEmpty) {
+  EXPECT_FLOAT_EQ(0, std::get<float>(TopKAccuracy(1).compute()));
+}
+
+TEST(StreamingMetrics, TestTopKAccuracyInvalidK) {
+  EXPECT_THROW(TopKAccuracy(0), exceptions::metrics::InvalidTopKException);
+}
+
+TEST(StreamingMetrics, TestTopKAccuracyInvalidDataset) {
+  TopKAccuracy accumulator(1);
+  EXPECT_THROW(accumulator.update(getLogits(), std::vector<int>{0}),
+               exceptions::metrics::InvalidDatasetException);
+}
+
+TEST(StreamingMetrics, TestTopKAccuracyMerge) {
+  Eigen::MatrixXd logits = getLogits();
+  std::vector<int> labels = getLabels();
+  TopKAccuracy expected(2), first(2), second(2);
+  expected.update(logits, labels);
+  first.update(logits.topRows(1), std::span(labels).first(1));
+  second.update(logits.bottomRows(2), std::span(labels).last(2));
+  first.merge(second);
+  EXPECT_FLOAT_EQ(std::get<float>(expected.compute()),
+                  std::get<float>(first.compute()));
+
+  EXPECT_THROW(first.merge(TopKAccuracy(1)),
+               exceptions::metrics::MismatchedAccumulatorException);
+  EXPECT_THROW(first.merge(ConfidenceHistogram(2)),
+               exceptions::metrics::MismatchedAccumulatorException);
+}
+#pragma endregion Top k accuracy
+
+#pragma region Confidence histogram
+TEST(StreamingMetrics, TestConfidenceHistogram) {
+  ConfidenceHistogram accumulator(4);
+  accumulator.update(Eigen::MatrixXd{{0, 0}, {10, 0}, {0, 10}},
+                     std::vector<int>{0, 0, 1});
+  std::vector<float> expected{0, 0, 1.0f / 3, 2.0f / 3};
+  EXPECT_EQ(expected, std::get<std::vector<float>>(accumulator.compute()));
+
+  accumulator.reset();
+  EXPECT_EQ(std::vector<float>(4),
+            std::get<std::vector<float>>(accumulator.compute()));
+}
+
+TEST(StreamingMetrics, TestConfidenceHistogramInvalidBins) {
+  EXPECT_THROW(ConfidenceHistogram(0),
+               exceptions::metrics::InvalidNumberOfBinsException);
+}
+
+TEST(StreamingMetrics, TestConfidenceHistogramMerge) {
+  ConfidenceHistogram first(4), second(4);
+  first.update(Eigen::MatrixXd{{0, 0}}, std::vector<int>{0});
+  second.update(Eigen::MatrixXd{{10, 0}, {0, 10}}, std::vector<int>{0, 1});
+  first.merge(second);
+  std::vector<float> expected{0, 0, 1.0f / 3, 2.0f / 3};
+  EXPECT_EQ(expected, std::get<std::vector<float>>(first.compute()));
+
+  EXPECT_THROW(first.merge(ConfidenceHistogram(2)),
+               exceptions::metrics::MismatchedAccumulatorException);
+  EXPECT_THROW(first.merge(CalibrationError(4)),
+               exceptions::metrics::MismatchedAccumulatorException);
+}
+#pragma endregion Confidence histogram
+
+#pragma region Calibration error
+TEST(StreamingMetrics, TestCalibrationError) {
+  CalibrationError calibrated(10), overconfident(10);
+  calibrated.update(Eigen::MatrixXd{{0, 0}, {0, 0}}, std::vector<int>{0, 1});
+  EXPECT_NEAR(0, std::get<float>(calibrated.compute()), 1e-6);
+
+  overconfident.update(Eigen::MatrixXd{{10, 0}}, std::vector<int>{1});
+  EXPECT_NEAR(1, std::get<float>(overconfident.compute()), 1e-4);
+  EXPECT_FLOAT_EQ(0, std::get<float>(CalibrationError(10).compute()));
+}
+#pragma endregion Calibration error
+
+#pragma region Registry
+TEST(StreamingMetrics, TestMakeAccumulator) {
+  for (const std::string &metric :
+       {"top_1_accuracy", "top_25_accuracy", "confidence_histogram",
+        "calibration_error"}) {
+    EXPECT_NE(nullptr, makeAccumulator(metric)) << metric;
+    EXPECT_TRUE(isStreamingMetric(metric)) << metric;
+  }
+  for (const std::string &metric :
+       {"accuracy", "loss", "top_0_accuracy", "top__accuracy",
+        "top_x_accuracy", "top_01_accuracy", "top_-1_accuracy"}) {
+    EXPECT_EQ(nullptr, makeAccumulator(metric)) << metric;
+    EXPECT_FALSE(isStreamingMetric(metric)) << metric;
+  }
+}
+
+TEST(StreamingMetrics, TestIsSingleValueMetric) {
+  for (const std::string &metric :
+       {"loss", "accuracy", "top_3_accuracy", "calibration_error"}) {
+    EXPECT_TRUE(isSingleValueMetric(metric)) << metric;
+  }
+  for (const std::string &metric :
+       {"precision", "f1_score", "confidence_histogram", "invalid"}) {
+    EXPECT_FALSE(isSingleValueMetric(metric)) << metric;
+  }
+}
+#pragma endregion Registry
+
+#pragma region Streaming metrics
+TEST(StreamingMetrics, TestStreamingMetrics) {
+  StreamingMetrics streaming({"loss", "accuracy", "top_2_accuracy"});
+  EXPECT_FALSE(streaming.empty());
+  EXPECT_TRUE(streaming.contains("top_2_accuracy"));
+  EXPECT_FALSE(streaming.contains("accuracy"));
+  EXPECT_TRUE(StreamingMetrics({"loss", "precision"}).empty());
+
+  streaming.update(getLogits(), getLabels());
+  EXPECT_FLOAT_EQ(1.0f / 3,
+                  std::get<float>(streaming.compute("top_2_accuracy")));
+  streaming.reset();
+  EXPECT_FLOAT_EQ(0, std::get<float>(streaming.compute("top_2_accuracy")));
+}
+
+TEST(StreamingMetrics, TestStreamingMetricsCopy) {
+  StreamingMetrics streaming({"top_3_accuracy"});
+  streaming.update(getLogits(), getLabels());
+  StreamingMetrics copy = streaming;
+  copy.reset();
+  EXPECT_FLOAT_EQ(1, std::get<float>(streaming.compute("top_3_accuracy")));
+  EXPECT_FLOAT_EQ(0, std::get<float>(copy.compute("top_3_accuracy")));
+}
+
+TEST(StreamingMetrics, TestStreamingMetricsMerge) {
+  StreamingMetrics first({"top_2_accuracy", "confidence_histogram"}),
+      second = first;
+  first.update(getLogits(), getLabels());
+  second.update(getLogits(), getLabels());
+  first.merge(second);
+  EXPECT_FLOAT_EQ(1.0f / 3, std::get<float>(first.compute("top_2_accuracy")));
+
+  EXPECT_THROW(first.merge(StreamingMetrics({"top_2_accuracy"})),
+               exceptions::metrics::MismatchedAccumulatorException);
+  EXPECT_THROW(first.merge(StreamingMetrics(
+                   {"top_2_accuracy", "calibration_error"})),
+               exceptions::metrics::MismatchedAccumulatorException);
+}
+#pragma endregion Streaming metrics
+#pragma endregion Tests
+} // namespace test_streaming_metrics
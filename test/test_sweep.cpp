@@ -0,0 +1,145 @@
+#include "exceptions/sweep.hpp"
+#include "image_loader.hpp"
+#include "sweep.hpp"
+#include <Eigen/Dense>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace sweep;
+
+namespace test_sweep {
+#pragma region Fixtures
+/*
+  Loads fixed samples, counting how many batchers were requested.
+*/
+struct CountingLoader : public loader::ImageLoader {
+  std::shared_ptr<const loader::minibatch> train, test;
+  mutable std::atomic<int> batchers = 0;
+
+  CountingLoader(int trainSize) {
+    Eigen::MatrixXd X{{4, -3, 2, 4}, {6, -3, 6, 1}, {5, 9, 8, 3},
+                      {8, -10, 8, -7}, {0, 3, 7, 5}, {7, -6, 8, 8},
+                      {1, -10, -7, 5}, {-6, 5, 4, -9}};
+    std::vector<int> y{0, 1, 1, 1, 0, 0, 1, 0};
+    this->train = std::make_shared<const loader::minibatch>(
+        X.topRows(trainSize),
+        std::vector<int>(y.begin(), y.begin() + trainSize));
+    this->test = std::make_shared<const loader::minibatch>(
+        X.bottomRows(X.rows() - trainSize),
+        std::vector<int>(y.begin() + trainSize, y.end()));
+    this->classes = {"0", "1"};
+  }
+
+  std::shared_ptr<loader::DatasetBatcher>
+  getBatcher(std::string dataset, int batchSize,
+             const loader::DatasetBatcher::KeywordArgs &kwargs =
+                 loader::DatasetBatcher::KeywordArgs()) const override {
+    ++this->batchers;
+    return std::make_shared<loader::InMemoryDatasetBatcher>(
+        dataset == "train" ? this->train : this->test, batchSize, kwargs);
+  }
+};
+
+std::vector<Trial> getTrials() {
+  Trial small{"small", 1e-2, 2, 2, {{3, "ReLU"}, {2}}},
+      large{"large", 1e-3, 4, 3, {{5, "ReLU"}, {5}, {2}}},
+      linear{"linear", 1e-2, 1, 1, {{2}}};
+  return {small, large, linear};
+}
+#pragma endregion Fixtures
+
+#pragma region Tests
+#pragma region Run
+TEST(Sweep, TestRun) {
+  CountingLoader loader(6);
+  std::vector<Trial> trials = getTrials();
+  RunKeywordArgs kwargs;
+  kwargs.workers = 2;
+  std::vector<Result> results = run(loader, trials, kwargs);
+
+  ASSERT_EQ(trials.size(), results.size());
+  for (int i = 0; i < trials.size(); ++i) {
+    EXPECT_EQ(trials[i].name, results[i].name);
+    EXPECT_EQ(trials[i].epochs, results[i].epochs) << trials[i].name;
+    EXPECT_TRUE(results[i].error.empty()) << results[i].error;
+    EXPECT_TRUE(results[i].metrics.contains("loss")) << trials[i].name;
+    EXPECT_TRUE(results[i].metrics.contains("accuracy")) << trials[i].name;
+    EXPECT_GE(results[i].seconds, 0) << trials[i].name;
+  }
+}
+
+TEST(Sweep, TestRunWithInMemoryLoader) {
+  CountingLoader source(6);
+  loader::InMemoryImageLoader loader(source);
+  int decoded = source.batchers;
+
+  std::vector<Result> results = run(loader, getTrials(), {.workers = 3});
+  EXPECT_EQ(decoded, source.batchers)
+      << "The source loader was read again after decoding.";
+  for (const Result &result : results) {
+    EXPECT_TRUE(result.error.empty()) << result.error;
+  }
+}
+
+TEST(Sweep, TestRunWithEarlyStopping) {
+  CountingLoader loader(6);
+  Trial trial{"stopped", 1e-12, 2, 5, {{3, "ReLU"}, {2}}};
+  trial.kwargs.earlyStoppingPatience = 1;
+  trial.kwargs.earlyStoppingMinDelta = 1;
+  std::vector<Result> results = run(loader, {trial});
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(2, results[0].epochs);
+}
+
+TEST(Sweep, TestRunWithFailedTrial) {
+  CountingLoader loader(6);
+  std::vector<Trial> trials = getTrials();
+  trials[0].layers = {{0}, {2}};
+  trials[1].batchSize = 0;
+  trials.push_back({"mismatched", 1e-2, 1, 1, {{3}}});
+  trials.push_back({"invalid activation", 1e-2, 1, 1, {{3, "Tanh"}, {2}}});
+  std::vector<Result> results = run(loader, trials, {.workers = 2});
+  EXPECT_FALSE(results[0].error.empty());
+  EXPECT_FALSE(results[1].error.empty());
+  EXPECT_TRUE(results[2].error.empty()) << results[2].error;
+  EXPECT_EQ(1, results[2].epochs);
+  EXPECT_FALSE(results[3].error.empty());
+  EXPECT_FALSE(results[4].error.empty());
+}
+
+TEST(Sweep, TestRunWithDefaultLayers) {
+  CountingLoader loader(6);
+  std::vector<Result> results = run(loader, {{"default", 1e-2, 2, 1}});
+  ASSERT_EQ(1, results.size());
+  EXPECT_TRUE(results[0].error.empty()) << results[0].error;
+  EXPECT_EQ(1, results[0].epochs);
+}
+
+TEST(Sweep, TestRunWithEmptyDataset) {
+  CountingLoader loader(0);
+  EXPECT_THROW(run(loader, getTrials()),
+               exceptions::sweep::EmptyDatasetException);
+}
+
+TEST(Sweep, TestRunWithNoTrials) {
+  CountingLoader loader(6);
+  EXPECT_TRUE(run(loader, {}).empty());
+}
+#pragma endregion Run
+
+#pragma region Print
+TEST(Sweep, TestPrintResultsWithFailedTrial) {
+  Result trained{"trained", {{"accuracy", 0.5}, {"loss", 1.25}}, 2, 0.5},
+      failed{"failed"};
+  failed.error = "Invalid.";
+  testing::internal::CaptureStdout();
+  printResults({trained, failed});
+  std::string output = testing::internal::GetCapturedStdout();
+  EXPECT_NE(std::string::npos, output.find("failed failed: Invalid."));
+}
+#pragma endregion Print
+#pragma endregion Tests
+} // namespace test_sweep
@@ -1,11 +1,16 @@
 #include "exceptions/json.hpp"
 #include "exceptions/utils.hpp"
 #include "fixtures.hpp"
+#include "utils/allocations.hpp"
 #include "utils/image.hpp"
+#include "utils/indicator.hpp"
 #include "utils/math.hpp"
 #include "utils/matrix.hpp"
+#include "utils/memory.hpp"
 #include "utils/path.hpp"
 #include "utils/string.hpp"
+#include "utils/timer.hpp"
+#include "utils/trace.hpp"
 #include <Eigen/Dense>
 #include <algorithm>
 #include <filesystem>
@@ -15,6 +20,7 @@
 #include <map>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -228,6 +234,30 @@ TEST(MathUtils, TestLogitsToPrediction) {
   }
 }
 #pragma endregion Logits to prediction
+
+#pragma region Stratified sample
+TEST(MathUtils, TestStratifiedSample) {
+  std::vector<int> labels{0, 0, 0, 0, 0, 0, 1, 1, 1, 2, 2, 2};
+  std::vector<int> indices = math::stratifiedSample(labels, 4, 0);
+  ASSERT_EQ(4, indices.size());
+  EXPECT_TRUE(std::is_sorted(indices.begin(), indices.end()));
+
+  std::map<int, int> counts;
+  for (int i : indices) {
+    ++counts[labels[i]];
+  }
+  std::map<int, int> expected{{0, 2}, {1, 1}, {2, 1}};
+  EXPECT_EQ(expected, counts);
+  EXPECT_EQ(indices, math::stratifiedSample(labels, 4, 0));
+}
+
+TEST(MathUtils, TestStratifiedSampleClamped) {
+  std::vector<int> labels{1, 0, 1};
+  std::vector<int> expected{0, 1, 2};
+  EXPECT_EQ(expected, math::stratifiedSample(labels, 5, 0));
+  EXPECT_TRUE(math::stratifiedSample(labels, 0, 0).empty());
+}
+#pragma endregion Stratified sample
 #pragma endregion Math
 
 #pragma region Path
@@ -355,4 +385,221 @@ TEST(StringUtils, TestTrim) {
   }
 }
 #pragma endregion String
+
+#pragma region Timer
+TEST(TimerUtils, TestStageTimerAdd) {
+  timer::StageTimer stageTimer;
+  stageTimer.add("Forward", 1);
+  stageTimer.add("Backward", 2);
+  stageTimer.add("Forward", 0.5);
+
+  const std::vector<timer::Timing> &timings = stageTimer.getTimings();
+  ASSERT_EQ(2, timings.size());
+  EXPECT_EQ("Forward", timings[0].stage);
+  EXPECT_DOUBLE_EQ(1.5, timings[0].seconds);
+  EXPECT_EQ(2, timings[0].calls);
+  EXPECT_EQ("Backward", timings[1].stage);
+  EXPECT_DOUBLE_EQ(2, timings[1].seconds);
+  EXPECT_EQ(1, timings[1].calls);
+  EXPECT_DOUBLE_EQ(3.5, stageTimer.getTotalSeconds());
+
+  stageTimer.clear();
+  EXPECT_TRUE(stageTimer.getTimings().empty());
+  EXPECT_DOUBLE_EQ(0, stageTimer.getTotalSeconds());
+}
+
+TEST(TimerUtils, TestScopedTimer) {
+  timer::StageTimer stageTimer;
+  for (int i = 0; i < 3; ++i) {
+    timer::ScopedTimer scope(&stageTimer, "Stage");
+  }
+  ASSERT_EQ(1, stageTimer.getTimings().size());
+  EXPECT_EQ(3, stageTimer.getTimings()[0].calls);
+  EXPECT_GE(stageTimer.getTimings()[0].seconds, 0);
+
+  // Disabled timers record nothing
+  timer::ScopedTimer scope(nullptr, "Stage");
+}
+#pragma endregion Timer
+
+#pragma region Trace
+/*
+  Get the names of the complete events of the thread with the given name.
+*/
+std::vector<std::string> getTraceEvents(const json &trace,
+                                        const std::string &threadName) {
+  int tid = -1;
+  for (const json &event : trace["traceEvents"]) {
+    if (event["ph"] == "M" && event["args"]["name"] == threadName) {
+      tid = event["tid"];
+    }
+  }
+  std::vector<std::string> names;
+  for (const json &event : trace["traceEvents"]) {
+    if (event["ph"] == "X" && event["tid"] == tid) {
+      names.push_back(event["name"]);
+    }
+  }
+  return names;
+}
+
+TEST(TraceUtils, TestScopedEvent) {
+  trace::start();
+  { trace::ScopedEvent event("Outer", "test"); }
+  std::thread worker([] {
+    trace::setThreadName("Worker");
+    trace::ScopedEvent event("Inner", "test");
+  });
+  worker.join();
+  trace::stop();
+  { trace::ScopedEvent event("Stopped", "test"); }
+
+  json values = trace::toJson();
+  EXPECT_EQ(std::vector<std::string>{"Outer"}, getTraceEvents(values, "Main"));
+  EXPECT_EQ(std::vector<std::string>{"Inner"},
+            getTraceEvents(values, "Worker"));
+  for (const json &event : values["traceEvents"]) {
+    if (event["ph"] == "X") {
+      EXPECT_EQ("test", event["cat"]);
+      EXPECT_GE(event["ts"].get<double>(), 0);
+      EXPECT_GE(event["dur"].get<double>(), 0);
+    }
+  }
+}
+
+TEST(TraceUtils, TestStartClearsEvents) {
+  trace::start();
+  { trace::ScopedEvent event("First", "test"); }
+  trace::start();
+  { trace::ScopedEvent event("Second", "test"); }
+  trace::stop();
+  EXPECT_EQ(std::vector<std::string>{"Second"},
+            getTraceEvents(trace::toJson(), "Main"));
+}
+
+TEST(TraceUtils, TestScopedTimerRecordsEvent) {
+  trace::start();
+  { timer::ScopedTimer scope(nullptr, "Stage", "test"); }
+  trace::stop();
+  EXPECT_EQ(std::vector<std::string>{"Stage"},
+            getTraceEvents(trace::toJson(), "Main"));
+}
+
+class TraceFile : public test_filesystem::BaseFileSystemFixture {};
+TEST_F(TraceFile, TestSave) {
+  trace::start();
+  { trace::ScopedEvent event("Event", "test"); }
+  trace::stop();
+  std::filesystem::path path = this->root / "traces" / "trace.json";
+  trace::save(path);
+
+  std::ifstream file(path);
+  json values = json::parse(file);
+  EXPECT_EQ(trace::toJson(), values);
+}
+#pragma endregion Trace
+
+#pragma region Memory
+TEST(MemoryUtils, TestGetSize) {
+  EXPECT_EQ(6 * sizeof(double), memory::getSize(Eigen::MatrixXd(2, 3)));
+  EXPECT_EQ(4 * sizeof(int), memory::getSize(Eigen::VectorXi(4)));
+  EXPECT_EQ(0, memory::getSize(std::shared_ptr<Eigen::MatrixXd>()));
+  EXPECT_EQ(2 * sizeof(double),
+            memory::getSize(std::make_shared<Eigen::MatrixXd>(1, 2)));
+}
+
+TEST(MemoryUtils, TestFormatBytes) {
+  EXPECT_EQ("512 B", memory::formatBytes(512));
+  EXPECT_EQ("1.50 KiB", memory::formatBytes(1536));
+  EXPECT_EQ("2.00 MiB", memory::formatBytes(2 << 20));
+  EXPECT_EQ("1.00 GiB", memory::formatBytes(1 << 30));
+}
+
+TEST(MemoryUtils, TestMemoryTracker) {
+  memory::MemoryTracker tracker;
+  tracker.record("Weights", 100);
+  tracker.record("Activations", 300);
+  tracker.record("Activations", 100);
+  tracker.record("Weights", 100);
+
+  const std::vector<memory::Usage> &usages = tracker.getUsages();
+  ASSERT_EQ(2, usages.size());
+  EXPECT_EQ("Weights", usages[0].component);
+  EXPECT_EQ(100, usages[0].peak);
+  EXPECT_EQ(100, usages[0].getSteadyState());
+  EXPECT_EQ("Activations", usages[1].component);
+  EXPECT_EQ(100, usages[1].current);
+  EXPECT_EQ(300, usages[1].peak);
+  EXPECT_EQ(200, usages[1].getSteadyState());
+
+  tracker.clear();
+  EXPECT_TRUE(tracker.getUsages().empty());
+}
+#pragma endregion Memory
+
+#pragma region Allocations
+TEST(AllocationUtils, TestScopedCounter) {
+  if (!allocations::isEnabled()) {
+    GTEST_SKIP() << "Allocations are only counted with COUNT_ALLOCATIONS.";
+  }
+
+  allocations::ScopedCounter counter;
+  EXPECT_EQ(0, counter.get().allocations);
+  Eigen::MatrixXd matrix(4, 4);
+  std::vector<int> values(8);
+  allocations::Counts counts = counter.get();
+  EXPECT_EQ(2, counts.allocations);
+  EXPECT_EQ(16 * sizeof(double) + 8 * sizeof(int), counts.bytes);
+}
+
+TEST(AllocationUtils, TestAllocationTracker) {
+  allocations::AllocationTracker tracker;
+  tracker.record("Train step", {10, 100});
+  tracker.record("Test step", {2, 8});
+  tracker.record("Train step", {20, 300});
+
+  const std::vector<allocations::Stage> &stages = tracker.getStages();
+  ASSERT_EQ(2, stages.size());
+  EXPECT_EQ("Train step", stages[0].stage);
+  EXPECT_EQ(2, stages[0].batches);
+  EXPECT_EQ(30, stages[0].allocations);
+  EXPECT_EQ(400, stages[0].bytes);
+  EXPECT_EQ(20, stages[0].maxAllocations);
+  EXPECT_EQ("Test step", stages[1].stage);
+  EXPECT_EQ(1, stages[1].batches);
+
+  tracker.clear();
+  EXPECT_TRUE(tracker.getStages().empty());
+}
+#pragma endregion Allocations
+
+#pragma region Indicators
+TEST(IndicatorUtils, TestSilentWhenDisabled) {
+  utils::indicators::setEnabled(false);
+  EXPECT_TRUE(utils::indicators::isSilent());
+  utils::indicators::setEnabled(true);
+}
+
+TEST(IndicatorUtils, TestProgressReporter) {
+  utils::indicators::setEnabled(false);
+  utils::indicators::ProgressReporter progress("Test", 10, 3);
+  EXPECT_EQ(3, progress.getProgress());
+  for (int i = 0; i < 4; ++i) {
+    progress.tick();
+  }
+  EXPECT_EQ(7, progress.getProgress());
+  progress.finish();
+  progress.finish();
+  utils::indicators::setEnabled(true);
+}
+
+TEST(IndicatorUtils, TestHiddenProgressReporter) {
+  testing::internal::CaptureStdout();
+  utils::indicators::ProgressReporter progress("Test", 10, 0, false);
+  progress.tick();
+  progress.finish();
+  EXPECT_EQ(1, progress.getProgress());
+  EXPECT_EQ("", testing::internal::GetCapturedStdout());
+}
+#pragma endregion Indicators
 } // namespace test_utils
\ No newline at end of file